@@ -0,0 +1,278 @@
+#include "CompressedGraph.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+CompressedGraph::CompressedGraph(uint32_t numVertices, vector<CompressedEdgeInput> edges)
+    : numVertices(numVertices) {
+    TraceSpan span("CompressedGraph", "encode");
+
+    // Каждое ребро дает две полудуги: u -> v с весом ребра и v -> u с нулем (или тоже с весом,
+    // если ребро неориентированное).
+    // Раскладываем их по вершинам сортировкой подсчетом
+    struct HalfArc {
+        uint32_t to;
+        int32_t capacity;
+    };
+
+    vector<uint64_t> start(numVertices + 1, 0);
+    for (const CompressedEdgeInput& e : edges) {
+        if (e.from != e.to) {
+            start[e.from + 1]++;
+            start[e.to + 1]++;
+        }
+    }
+    for (uint32_t u = 0; u < numVertices; u++) {
+        start[u + 1] += start[u];
+    }
+
+    vector<HalfArc> half(start[numVertices]);
+    {
+        vector<uint64_t> pos(start.begin(), start.end() - 1);
+        for (const CompressedEdgeInput& e : edges) {
+            if (e.from != e.to) {
+                half[pos[e.from]++] = { e.to, e.capacity };
+                half[pos[e.to]++] = { e.from, e.undirected ? e.capacity : 0 };
+            }
+        }
+    }
+
+    // Входной список больше не нужен - освобождаем память до кодирования
+    edges.clear();
+    edges.shrink_to_fit();
+
+    // Сортируем соседей каждой вершины и сливаем повторы, складывая пропускные способности
+    arcOffset.assign(numVertices + 1, 0);
+    uint64_t written = 0;
+    for (uint32_t u = 0; u < numVertices; u++) {
+        arcOffset[u] = written;
+        sort(half.begin() + start[u], half.begin() + start[u + 1],
+            [](const HalfArc& a, const HalfArc& b) { return a.to < b.to; });
+
+        for (uint64_t i = start[u]; i < start[u + 1]; i++) {
+            if (written > arcOffset[u] && half[written - 1].to == half[i].to) {
+                half[written - 1].capacity += half[i].capacity;
+            }
+            else {
+                half[written++] = half[i];
+            }
+        }
+    }
+    arcOffset[numVertices] = written;
+    half.resize(written);
+    start.clear();
+    start.shrink_to_fit();
+
+    capacities.resize(written);
+    for (uint64_t i = 0; i < written; i++) {
+        capacities[i] = half[i].capacity;
+    }
+
+    // Кодируем списки. Списки симметричны и отсортированы, поэтому при обходе u по возрастанию
+    // позиция u в списке соседа v - это просто число уже встреченных дуг в v
+    vector<uint32_t> reverseRank(numVertices, 0);
+    byteOffset.assign(numVertices + 1, 0);
+    bytes.reserve(written * 2);
+
+    for (uint32_t u = 0; u < numVertices; u++) {
+        byteOffset[u] = bytes.size();
+        uint32_t previous = 0;
+
+        for (uint64_t i = arcOffset[u]; i < arcOffset[u + 1]; i++) {
+            uint32_t v = half[i].to;
+            writeVarint(bytes, v - previous);
+            writeVarint(bytes, reverseRank[v]++);
+            previous = v;
+        }
+    }
+    byteOffset[numVertices] = bytes.size();
+    bytes.shrink_to_fit();
+}
+
+size_t CompressedGraph::memoryBytes() const {
+    return byteOffset.size() * sizeof(uint64_t) + arcOffset.size() * sizeof(uint64_t) +
+        bytes.size() + capacities.size() * sizeof(int32_t);
+}
+
+long long compressedDinic(const CompressedGraph& graph, uint32_t source, uint32_t sink,
+    vector<int32_t>* residualOut) {
+    uint32_t n = graph.vertexCount();
+    if (source >= n || sink >= n || source == sink) {
+        return 0;
+    }
+
+    TraceSpan solveSpan("compressedDinic", "solve");
+    vector<int32_t> residual(graph.capacityArray());
+    vector<int> level(n);
+    vector<uint32_t> bfsQueue(n);
+
+    // Текущая дуга каждой вершины хранится как курсор декодера
+    vector<CompressedGraph::ArcCursor> current(n);
+    vector<char> exhausted(n);
+
+    vector<uint64_t> pathArc(n);
+    vector<uint64_t> pathReverse(n);
+    vector<uint32_t> pathTo(n);
+
+    // BFS для построения слоистой сети
+    auto bfs = [&]() -> bool {
+        TraceSpan span("compressedDinic", "bfs");
+        fill(level.begin(), level.end(), -1);
+        size_t tail = 0;
+        bfsQueue[tail++] = source;
+        level[source] = 0;
+
+        for (size_t head = 0; head < tail; head++) {
+            uint32_t u = bfsQueue[head];
+            CompressedGraph::ArcCursor arc;
+            for (bool ok = graph.first(u, arc); ok; ok = graph.next(arc)) {
+                if (residual[arc.index] > 0 && level[arc.to] == -1) {
+                    level[arc.to] = level[u] + 1;
+                    bfsQueue[tail++] = arc.to;
+                }
+            }
+        }
+
+        return level[sink] != -1;
+        };
+
+    long long maxFlow = 0;
+
+    while (bfs()) {
+        TraceSpan span("compressedDinic", "blocking flow");
+        long long phaseStart = maxFlow;
+        for (uint32_t u = 0; u < n; u++) {
+            exhausted[u] = !graph.first(u, current[u]);
+        }
+
+        // Блокирующий поток итеративным обходом в глубину
+        uint32_t u = source;
+        size_t depth = 0;
+
+        while (true) {
+            if (u == sink) {
+                int32_t pushed = INT_MAX;
+                for (size_t i = 0; i < depth; i++) {
+                    pushed = min(pushed, residual[pathArc[i]]);
+                }
+
+                size_t firstSaturated = depth;
+                for (size_t i = 0; i < depth; i++) {
+                    residual[pathArc[i]] -= pushed;
+                    residual[pathReverse[i]] += pushed;
+                    if (residual[pathArc[i]] == 0 && firstSaturated == depth) {
+                        firstSaturated = i;
+                    }
+                }
+
+                maxFlow += pushed;
+                depth = firstSaturated;
+                u = depth == 0 ? source : pathTo[depth - 1];
+                continue;
+            }
+
+            CompressedGraph::ArcCursor& arc = current[u];
+            while (!exhausted[u] && !(residual[arc.index] > 0 && level[arc.to] == level[u] + 1)) {
+                exhausted[u] = !graph.next(arc);
+            }
+
+            if (!exhausted[u]) {
+                pathArc[depth] = arc.index;
+                pathReverse[depth] = arc.reverse;
+                pathTo[depth] = arc.to;
+                depth++;
+                u = arc.to;
+                continue;
+            }
+
+            // Тупик: вершина исключается из слоистой сети
+            if (u == source) {
+                break;
+            }
+            level[u] = -1;
+            depth--;
+            u = depth == 0 ? source : pathTo[depth - 1];
+            exhausted[u] = !graph.next(current[u]);
+        }
+
+        span.annotate("pushed", maxFlow - phaseStart);
+    }
+
+    if (residualOut) {
+        residualOut->swap(residual);
+    }
+
+    return maxFlow;
+}
+
+int compressedMaxFlow(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
+    // Проверка входных данных
+    if (graph.empty()) {
+        return 0;
+    }
+
+    if (graph.find(sourceId) == graph.end()) {
+        return 0;
+    }
+
+    if (graph.find(sinkId) == graph.end()) {
+        return 0;
+    }
+
+    if (sourceId == sinkId) {
+        return 0;
+    }
+
+    TraceSpan solveSpan("compressedMaxFlow", "solve");
+    TraceSpan convertSpan("compressedMaxFlow", "convert");
+
+    // Сопоставляем ID вершинам 32-битные индексы
+    unordered_map<int, uint32_t> nodeIdToIndex;
+    vector<Node*> indexToNode;
+    for (auto& pair : graph) {
+        nodeIdToIndex[pair.first] = indexToNode.size();
+        indexToNode.push_back(pair.second);
+    }
+
+    vector<CompressedEdgeInput> edges;
+    for (auto& pair : graph) {
+        uint32_t u = nodeIdToIndex[pair.first];
+        for (Edge* edge : pair.second->edges) {
+            edges.push_back({ u, nodeIdToIndex[edge->adjacentNode->id], edge->weight, edge->undirected });
+        }
+    }
+
+    CompressedGraph compressed(indexToNode.size(), move(edges));
+    convertSpan.end();
+
+    CertificateHook hook = getCertificateHook();
+    vector<int32_t> residual;
+    int maxFlow = compressedDinic(compressed, nodeIdToIndex[sourceId], nodeIdToIndex[sinkId],
+        hook ? &residual : nullptr);
+
+    if (hook) {
+        TraceSpan span("compressedMaxFlow", "certificate");
+
+        // Дуги сжатого графа объединяют параллельные ребра, поэтому поток раскладывается по парам вершин
+        unordered_map<Node*, unordered_map<Node*, int>> netFlow;
+        for (uint32_t u = 0; u < compressed.vertexCount(); u++) {
+            CompressedGraph::ArcCursor arc;
+            for (bool ok = compressed.first(u, arc); ok; ok = compressed.next(arc)) {
+                netFlow[indexToNode[u]][indexToNode[arc.to]] = compressed.capacity(arc.index) - residual[arc.index];
+            }
+        }
+
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        assignNetFlow(graph, netFlow, certificate);
+        buildResidualCut(graph, sourceId, certificate);
+        hook("compressedMaxFlow", graph, sourceId, sinkId, certificate);
+    }
+
+    return maxFlow;
+}
\ No newline at end of file
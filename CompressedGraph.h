@@ -0,0 +1,118 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Ребро входного списка для построения сжатого графа; вершины - индексы 0..n-1.
+// Неориентированное ребро дает ту же пару дуг, но с capacity в обе стороны.
+struct CompressedEdgeInput {
+    uint32_t from;
+    uint32_t to;
+    int32_t capacity;
+    bool undirected = false;
+};
+
+// Компактная остаточная сеть для больших разреженных графов.
+// Для каждой вершины хранится отсортированный список соседей (входящих и исходящих вместе),
+// каждая запись - varint разности с предыдущим соседом и varint позиции обратной дуги
+// в списке соседа. Параллельные и встречные ребра сливаются в одну пару дуг.
+// Пропускные способности лежат отдельно в несжатом массиве, индекс которого - номер дуги.
+class CompressedGraph {
+public:
+    // Курсор по дугам одной вершины, декодирующий запись при переходе
+    struct ArcCursor {
+        const uint8_t* next;
+        uint64_t index;
+        uint64_t end;
+        uint32_t to;
+        uint64_t reverse;
+    };
+
+    CompressedGraph(uint32_t numVertices, std::vector<CompressedEdgeInput> edges);
+
+    uint32_t vertexCount() const {
+        return numVertices;
+    }
+
+    uint64_t arcCount() const {
+        return arcOffset[numVertices];
+    }
+
+    // Исходная пропускная способность дуги (сумма весов ребер в этом направлении)
+    int32_t capacity(uint64_t arc) const {
+        return capacities[arc];
+    }
+
+    // Весь массив пропускных способностей - начальное значение остаточной сети
+    const std::vector<int32_t>& capacityArray() const {
+        return capacities;
+    }
+
+    // Байты, занятые смещениями, закодированными списками и пропускными способностями
+    size_t memoryBytes() const;
+
+    // Встает на первую дугу вершины u; false, если дуг нет
+    bool first(uint32_t u, ArcCursor& cursor) const {
+        cursor.next = bytes.data() + byteOffset[u];
+        cursor.index = arcOffset[u];
+        cursor.end = arcOffset[u + 1];
+        cursor.to = 0;
+        if (cursor.index == cursor.end) {
+            return false;
+        }
+        decode(cursor);
+        return true;
+    }
+
+    // Переходит к следующей дуге; false, если дуги вершины закончились
+    bool next(ArcCursor& cursor) const {
+        if (++cursor.index == cursor.end) {
+            return false;
+        }
+        decode(cursor);
+        return true;
+    }
+
+private:
+    static uint64_t readVarint(const uint8_t*& p) {
+        uint64_t value = 0;
+        int shift = 0;
+        while (*p & 0x80) {
+            value |= uint64_t(*p++ & 0x7f) << shift;
+            shift += 7;
+        }
+        value |= uint64_t(*p++) << shift;
+        return value;
+    }
+
+    static void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(uint8_t(value));
+    }
+
+    void decode(ArcCursor& cursor) const {
+        cursor.to += uint32_t(readVarint(cursor.next));
+        cursor.reverse = arcOffset[cursor.to] + readVarint(cursor.next);
+    }
+
+    uint32_t numVertices;
+    std::vector<uint64_t> byteOffset;
+    std::vector<uint64_t> arcOffset;
+    std::vector<uint8_t> bytes;
+    std::vector<int32_t> capacities;
+};
+
+// Алгоритм Диница на сжатом графе: декодирование соседей на лету, остаточные
+// пропускные способности - отдельный массив int32 по номерам дуг.
+// Если residualOut задан, в него возвращается итоговая остаточная сеть.
+long long compressedDinic(const CompressedGraph& graph, uint32_t source, uint32_t sink,
+    std::vector<int32_t>* residualOut = nullptr);
+
+// Та же сигнатура, что у остальных алгоритмов: строит сжатый граф и запускает compressedDinic
+int compressedMaxFlow(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId);
\ No newline at end of file
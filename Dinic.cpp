@@ -1,4 +1,6 @@
 #include "Dinic.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +39,9 @@ int dinic(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
         return 0;
     }
 
+    TraceSpan solveSpan("dinic", "solve");
+    TraceSpan convertSpan("dinic", "convert");
+
     // Создаем сеть для алгоритма Диница
     unordered_map<int, vector<FlowEdge>> flowNetwork;
     unordered_map<int, int> nodeIdToIndex;
@@ -50,6 +55,10 @@ int dinic(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
         index++;
     }
 
+    // Для отладочного хука запоминаем положение прямой дуги каждого исходного ребра
+    CertificateHook hook = getCertificateHook();
+    vector<pair<Edge*, pair<int, int>>> edgeArcs;
+
     // Строим сеть потоков
     for (auto& pair : graph) {
         int u = nodeIdToIndex[pair.first];
@@ -59,16 +68,21 @@ int dinic(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
             int v = nodeIdToIndex[edge->adjacentNode->id];
             int capacity = edge->weight;
 
+            if (hook) {
+                edgeArcs.push_back({ edge, { u, (int)flowNetwork[u].size() } });
+            }
+
             // Прямое ребро
             flowNetwork[u].push_back(FlowEdge(v, capacity, flowNetwork[v].size()));
-            // Обратное ребро
-            flowNetwork[v].push_back(FlowEdge(u, 0, flowNetwork[u].size() - 1));
+            // Обратное ребро (у неориентированного ребра несет тот же вес)
+            flowNetwork[v].push_back(FlowEdge(u, edge->undirected ? capacity : 0, flowNetwork[u].size() - 1));
         }
     }
 
     int source = nodeIdToIndex[sourceId];
     int sink = nodeIdToIndex[sinkId];
     int n = graph.size();
+    convertSpan.end();
 
     int maxFlow = 0;
     vector<int> level(n);
@@ -76,6 +90,7 @@ int dinic(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
 
     // BFS для построения слоистой сети
     auto bfs = [&]() -> bool {
+        TraceSpan span("dinic", "bfs");
         fill(level.begin(), level.end(), -1);
         queue<int> q;
         q.push(source);
@@ -120,12 +135,27 @@ int dinic(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
 
     // Основной цикл алгоритма Диница
     while (bfs()) {
+        TraceSpan span("dinic", "blocking flow");
         fill(ptr.begin(), ptr.end(), 0);
 
         int pushed;
+        int phaseFlow = 0;
         while ((pushed = dfs(source, INT_MAX)) > 0) {
-            maxFlow += pushed;
+            phaseFlow += pushed;
+        }
+        maxFlow += phaseFlow;
+        span.annotate("pushed", phaseFlow);
+    }
+
+    if (hook) {
+        TraceSpan span("dinic", "certificate");
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        for (auto& arc : edgeArcs) {
+            certificate.edgeFlow[arc.first] = arc.first->weight - flowNetwork[arc.second.first][arc.second.second].capacity;
         }
+        buildResidualCut(graph, sourceId, certificate);
+        hook("dinic", graph, sourceId, sinkId, certificate);
     }
 
     return maxFlow;
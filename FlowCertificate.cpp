@@ -0,0 +1,172 @@
+#include "FlowCertificate.h"
+#include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <queue>
+#include <string>
+#include <algorithm>
+
+using namespace std;
+
+static CertificateHook certificateHook = nullptr;
+
+void setCertificateHook(CertificateHook hook) {
+    certificateHook = hook;
+}
+
+CertificateHook getCertificateHook() {
+    return certificateHook;
+}
+
+bool verifyFlowCertificate(unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    const FlowCertificate& certificate, string& error) {
+    error.clear();
+
+    if (graph.find(sourceId) == graph.end() || graph.find(sinkId) == graph.end()) {
+        error = "источник или сток отсутствует в графе";
+        return false;
+    }
+
+    if (certificate.sourceSide.count(sourceId) == 0) {
+        error = "источник не лежит на стороне источника разреза";
+        return false;
+    }
+
+    if (certificate.sourceSide.count(sinkId) != 0) {
+        error = "сток лежит на стороне источника разреза";
+        return false;
+    }
+
+    // Один проход по ребрам: пропускные способности, баланс вершин и величина разреза
+    unordered_map<int, long long> balance;
+    long long cutValue = 0;
+
+    for (auto& pair : graph) {
+        int u = pair.first;
+        bool uInSource = certificate.sourceSide.count(u) != 0;
+
+        for (Edge* edge : pair.second->edges) {
+            int v = edge->adjacentNode->id;
+
+            auto it = certificate.edgeFlow.find(edge);
+            int flow = it == certificate.edgeFlow.end() ? 0 : it->second;
+
+            // Поток по неориентированному ребру может идти в обратную сторону (отрицательный)
+            int lowerBound = edge->undirected ? -edge->weight : 0;
+            if (flow < lowerBound || flow > edge->weight) {
+                error = "поток " + to_string(flow) + " по ребру " + to_string(u) + " -> " + to_string(v) +
+                    " вне границ [" + to_string(lowerBound) + ", " + to_string(edge->weight) + "]";
+                return false;
+            }
+
+            balance[u] -= flow;
+            balance[v] += flow;
+
+            bool vInSource = certificate.sourceSide.count(v) != 0;
+            if ((uInSource && !vInSource) || (edge->undirected && vInSource && !uInSource)) {
+                cutValue += edge->weight;
+            }
+        }
+    }
+
+    for (auto& pair : balance) {
+        if (pair.first != sourceId && pair.first != sinkId && pair.second != 0) {
+            error = "нарушено сохранение потока в вершине " + to_string(pair.first) +
+                " (дисбаланс " + to_string(pair.second) + ")";
+            return false;
+        }
+    }
+
+    if (balance[sinkId] != certificate.flowValue) {
+        error = "в сток приходит " + to_string(balance[sinkId]) + ", заявлено " +
+            to_string(certificate.flowValue);
+        return false;
+    }
+
+    if (cutValue != certificate.flowValue) {
+        error = "величина разреза " + to_string(cutValue) + " не равна величине потока " +
+            to_string(certificate.flowValue);
+        return false;
+    }
+
+    return true;
+}
+
+void buildResidualCut(unordered_map<int, Node*>& graph, int sourceId, FlowCertificate& certificate) {
+    certificate.sourceSide.clear();
+
+    auto sourceIt = graph.find(sourceId);
+    if (sourceIt == graph.end()) {
+        return;
+    }
+
+    // Остаточные дуги: прямая, если ребро не насыщено, и обратная, если по ребру идет поток
+    unordered_map<Node*, vector<Node*>> residual;
+    for (auto& pair : graph) {
+        Node* u = pair.second;
+
+        for (Edge* edge : u->edges) {
+            auto it = certificate.edgeFlow.find(edge);
+            int flow = it == certificate.edgeFlow.end() ? 0 : it->second;
+
+            if (flow < edge->weight) {
+                residual[u].push_back(edge->adjacentNode);
+            }
+            if (flow > (edge->undirected ? -edge->weight : 0)) {
+                residual[edge->adjacentNode].push_back(u);
+            }
+        }
+    }
+
+    queue<Node*> q;
+    q.push(sourceIt->second);
+    certificate.sourceSide.insert(sourceId);
+
+    while (!q.empty()) {
+        Node* u = q.front();
+        q.pop();
+
+        for (Node* v : residual[u]) {
+            if (certificate.sourceSide.insert(v->id).second) {
+                q.push(v);
+            }
+        }
+    }
+}
+
+void assignNetFlow(unordered_map<int, Node*>& graph,
+    unordered_map<Node*, unordered_map<Node*, int>>& netFlow, FlowCertificate& certificate) {
+    for (auto& pair : graph) {
+        Node* u = pair.second;
+
+        // Жадно заполняем параллельные ребра u -> v, пока не исчерпан чистый поток.
+        // Неориентированное ребро хранится у одного конца и забирает поток в обе стороны
+        for (Edge* edge : u->edges) {
+            Node* v = edge->adjacentNode;
+            int& forward = netFlow[u][v];
+
+            if (forward > 0) {
+                int flow = min(forward, edge->weight);
+                certificate.edgeFlow[edge] = flow;
+                forward -= flow;
+                continue;
+            }
+
+            int& backward = netFlow[v][u];
+            if (edge->undirected && backward > 0) {
+                int flow = min(backward, edge->weight);
+                certificate.edgeFlow[edge] = -flow;
+                backward -= flow;
+            }
+        }
+    }
+}
+
+void reportFlowCertificate(const char* solverName, unordered_map<int, Node*>& graph,
+    int sourceId, int sinkId, const FlowCertificate& certificate) {
+    string error;
+    if (!verifyFlowCertificate(graph, sourceId, sinkId, certificate, error)) {
+        cerr << "  [проверка] " << solverName << ": " << error << endl;
+    }
+}
\ No newline at end of file
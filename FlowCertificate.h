@@ -0,0 +1,40 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+
+// Сертификат максимального потока: поток по каждому ребру исходного графа
+// (для неориентированного ребра - со знаком, отрицательный идет против adjacentNode),
+// сторона источника разреза и заявленная величина потока
+struct FlowCertificate {
+    std::unordered_map<Edge*, int> edgeFlow;
+    std::unordered_set<int> sourceSide;
+    int flowValue = 0;
+};
+
+// Проверка сертификата за O(V + E): ограничения пропускных способностей, сохранение потока
+// и равенство величины разреза величине потока. При ошибке описание записывается в error.
+bool verifyFlowCertificate(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    const FlowCertificate& certificate, std::string& error);
+
+// Заполняет sourceSide вершинами, достижимыми из источника в остаточной сети потока edgeFlow
+void buildResidualCut(std::unordered_map<int, Node*>& graph, int sourceId, FlowCertificate& certificate);
+
+// Раскладывает чистый поток между парами вершин (netFlow[u][v] = -netFlow[v][u]) по ребрам u -> v
+// и по неориентированным ребрам между u и v (поток против ребра записывается со знаком минус)
+void assignNetFlow(std::unordered_map<int, Node*>& graph,
+    std::unordered_map<Node*, std::unordered_map<Node*, int>>& netFlow, FlowCertificate& certificate);
+
+// Отладочный хук: если установлен, каждый алгоритм после завершения строит сертификат и передает его сюда.
+// pseudoflow останавливается после первой фазы без допустимого потока и хук не вызывает.
+typedef void (*CertificateHook)(const char* solverName, std::unordered_map<int, Node*>& graph,
+    int sourceId, int sinkId, const FlowCertificate& certificate);
+
+void setCertificateHook(CertificateHook hook);
+CertificateHook getCertificateHook();
+
+// Стандартный хук: проверяет сертификат и печатает ошибку в cerr
+void reportFlowCertificate(const char* solverName, std::unordered_map<int, Node*>& graph,
+    int sourceId, int sinkId, const FlowCertificate& certificate);
\ No newline at end of file
@@ -1,4 +1,6 @@
 ﻿#include "FordFulkerson.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +39,9 @@ int fordFulkerson(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
         return 0;
     }
 
+    TraceSpan solveSpan("fordFulkerson", "solve");
+    TraceSpan convertSpan("fordFulkerson", "convert");
+
     Node* source = graph[sourceId];
     Node* sink = graph[sinkId];
 
@@ -51,14 +56,18 @@ int fordFulkerson(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
             ResidualEdge forward(u, v, edge->weight, edge, true);
             residualGraph[u].push_back(forward);
 
-            ResidualEdge backward(v, u, 0, nullptr, false);
+            // Неориентированное ребро - та же пара дуг, но обратная дуга тоже несет вес ребра
+            ResidualEdge backward(v, u, edge->undirected ? edge->weight : 0, edge, false);
             residualGraph[v].push_back(backward);
         }
     }
 
+    convertSpan.end();
+
     int maxFlow = 0;
 
     while (true) {
+        TraceSpan bfsSpan("fordFulkerson", "bfs");
         queue<Node*> q;
         unordered_map<Node*, bool> visited;
         unordered_map<Node*, ResidualEdge*> parent;
@@ -90,8 +99,11 @@ int fordFulkerson(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
             if (foundPath) break;
         }
 
+        bfsSpan.end();
+
         if (!foundPath) break;
 
+        TraceSpan augmentSpan("fordFulkerson", "augment");
         int pathFlow = INT_MAX;
         Node* v = sink;
 
@@ -117,6 +129,26 @@ int fordFulkerson(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
         }
 
         maxFlow += pathFlow;
+        augmentSpan.annotate("pushed", pathFlow);
+    }
+
+    // Обратная дуга при увеличении ищется по первому совпадению конца, поэтому поток
+    // по отдельным ребрам восстанавливается через чистый поток между парами вершин
+    if (CertificateHook hook = getCertificateHook()) {
+        TraceSpan span("fordFulkerson", "certificate");
+        unordered_map<Node*, unordered_map<Node*, int>> netFlow;
+        for (auto& pair : residualGraph) {
+            for (ResidualEdge& re : pair.second) {
+                int initial = re.isForward || re.originalEdge->undirected ? re.originalEdge->weight : 0;
+                netFlow[re.from][re.to] += initial - re.capacity;
+            }
+        }
+
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        assignNetFlow(graph, netFlow, certificate);
+        buildResidualCut(graph, sourceId, certificate);
+        hook("fordFulkerson", graph, sourceId, sinkId, certificate);
     }
 
     return maxFlow;
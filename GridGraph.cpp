@@ -0,0 +1,390 @@
+#include "GridGraph.h"
+#include "SolverTrace.h"
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <climits>
+
+using namespace std;
+
+GridGraph::GridGraph(int width, int height, int depth, GridConnectivity connectivity)
+    : sizeX(max(width, 0)), sizeY(max(height, 0)), sizeZ(max(depth, 0)) {
+    // Лексикографический порядок (dz, dy, dx) симметричен: противоположные смещения
+    // стоят на зеркальных позициях списка
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int manhattan = abs(dx) + abs(dy) + abs(dz);
+                if (manhattan == 0) {
+                    continue;
+                }
+
+                bool used = false;
+                switch (connectivity) {
+                case Grid4:
+                    used = dz == 0 && manhattan == 1;
+                    break;
+                case Grid8:
+                    used = dz == 0;
+                    break;
+                case Grid6:
+                    used = manhattan == 1;
+                    break;
+                case Grid26:
+                    used = true;
+                    break;
+                }
+
+                if (used) {
+                    offsets.push_back({ dx, dy, dz, (dz * sizeY + dy) * sizeX + dx });
+                }
+            }
+        }
+    }
+
+    capacities.assign(offsets.size(), vector<int>(pixelCount(), 0));
+    sourceCapacities.assign(pixelCount(), 0);
+    sinkCapacities.assign(pixelCount(), 0);
+}
+
+int GridGraph::neighbor(int pixel, int direction) const {
+    const Offset& o = offsets[direction];
+    int x = pixel % sizeX + o.dx;
+    int y = pixel / sizeX % sizeY + o.dy;
+    int z = pixel / (sizeX * sizeY) + o.dz;
+
+    if (x < 0 || x >= sizeX || y < 0 || y >= sizeY || z < 0 || z >= sizeZ) {
+        return -1;
+    }
+    return pixel + o.step;
+}
+
+long long gridMaxFlow(const GridGraph& grid, vector<char>* sourceSide) {
+    int n = grid.pixelCount();
+    int directions = grid.directionCount();
+    const vector<GridGraph::Offset>& offsets = grid.offsets;
+    int sizeX = grid.sizeX;
+    int sizeY = grid.sizeY;
+    int sizeZ = grid.sizeZ;
+
+    if (sourceSide) {
+        sourceSide->assign(n, 0);
+    }
+    if (n == 0) {
+        return 0;
+    }
+
+    TraceSpan solveSpan("gridMaxFlow", "solve");
+    TraceSpan convertSpan("gridMaxFlow", "convert");
+
+    // Остаточная сеть: дуга pixel -> сосед в направлении k лежит в residual[k][pixel],
+    // обратная к ней - в residual[opposite(k)][сосед]
+    vector<vector<int>> residual(grid.capacities);
+
+    // Поток источник -> пиксель -> сток проходит сразу; остается одна терминальная дуга:
+    // terminal > 0 - из источника, terminal < 0 - в сток
+    long long maxFlow = 0;
+    vector<int> terminal(n);
+    for (int p = 0; p < n; p++) {
+        maxFlow += min(grid.sourceCapacities[p], grid.sinkCapacities[p]);
+        terminal[p] = grid.sourceCapacities[p] - grid.sinkCapacities[p];
+    }
+
+    // Деревья поиска: родитель хранится как направление к нему
+    const char FREE = 0, SOURCE_TREE = 1, SINK_TREE = 2;
+    const int TERMINAL = directions;
+    const int ORPHAN = directions + 1;
+    const int INFINITE_DISTANCE = INT_MAX;
+
+    convertSpan.end();
+
+    vector<char> tree(n, FREE);
+    vector<int> parent(n, ORPHAN);
+    vector<int> timestamp(n, 0);
+    vector<int> distance(n, 0);
+    int time = 0;
+
+    // Активные вершины - очередь FIFO с флагом присутствия
+    vector<int> activeQueue;
+    vector<char> isActive(n, 0);
+    size_t activeHead = 0;
+    vector<int> orphans;
+    long long augmentations = 0;
+
+    auto activate = [&](int p) {
+        if (!isActive[p]) {
+            isActive[p] = 1;
+            activeQueue.push_back(p);
+        }
+        };
+
+    for (int p = 0; p < n; p++) {
+        if (terminal[p] != 0) {
+            tree[p] = terminal[p] > 0 ? SOURCE_TREE : SINK_TREE;
+            parent[p] = TERMINAL;
+            distance[p] = 1;
+            activate(p);
+        }
+    }
+
+    // Сосед по смещению с проверкой границ по заранее вычисленным координатам
+    auto neighborAt = [&](int p, int x, int y, int z, int k) -> int {
+        const GridGraph::Offset& o = offsets[k];
+        int nx = x + o.dx;
+        int ny = y + o.dy;
+        int nz = z + o.dz;
+        if (nx < 0 || nx >= sizeX || ny < 0 || ny >= sizeY || nz < 0 || nz >= sizeZ) {
+            return -1;
+        }
+        return p + o.step;
+        };
+
+    // Дуга между вершиной дерева и ее родителем: в дереве источника - от родителя к вершине,
+    // в дереве стока - от вершины к родителю
+    auto treeArc = [&](int p) -> int& {
+        int k = parent[p];
+        return tree[p] == SOURCE_TREE ? residual[directions - 1 - k][p + offsets[k].step] : residual[k][p];
+        };
+
+    auto makeOrphan = [&](int p) {
+        parent[p] = ORPHAN;
+        orphans.push_back(p);
+        };
+
+    // Увеличение вдоль пути источник -> sourceEnd -> sinkEnd -> сток; k - направление средней дуги
+    auto augment = [&](int sourceEnd, int sinkEnd, int k) {
+        int bottleneck = residual[k][sourceEnd];
+        for (int p = sourceEnd; ; p += offsets[parent[p]].step) {
+            if (parent[p] == TERMINAL) {
+                bottleneck = min(bottleneck, terminal[p]);
+                break;
+            }
+            bottleneck = min(bottleneck, treeArc(p));
+        }
+        for (int p = sinkEnd; ; p += offsets[parent[p]].step) {
+            if (parent[p] == TERMINAL) {
+                bottleneck = min(bottleneck, -terminal[p]);
+                break;
+            }
+            bottleneck = min(bottleneck, treeArc(p));
+        }
+
+        residual[k][sourceEnd] -= bottleneck;
+        residual[directions - 1 - k][sinkEnd] += bottleneck;
+
+        for (int p = sourceEnd; ; ) {
+            if (parent[p] == TERMINAL) {
+                terminal[p] -= bottleneck;
+                if (terminal[p] == 0) {
+                    makeOrphan(p);
+                }
+                break;
+            }
+            int k2 = parent[p];
+            int next = p + offsets[k2].step;
+            residual[k2][p] += bottleneck;
+            if ((treeArc(p) -= bottleneck) == 0) {
+                makeOrphan(p);
+            }
+            p = next;
+        }
+        for (int p = sinkEnd; ; ) {
+            if (parent[p] == TERMINAL) {
+                terminal[p] += bottleneck;
+                if (terminal[p] == 0) {
+                    makeOrphan(p);
+                }
+                break;
+            }
+            int k2 = parent[p];
+            int next = p + offsets[k2].step;
+            residual[directions - 1 - k2][next] += bottleneck;
+            if ((treeArc(p) -= bottleneck) == 0) {
+                makeOrphan(p);
+            }
+            p = next;
+        }
+
+        maxFlow += bottleneck;
+        augmentations++;
+        };
+
+    // Усыновление сирот: ищем родителя того же дерева с остаточной дугой и путем до терминала,
+    // предпочитая ближайший к терминалу (расстояния кешируются по метке времени)
+    auto adopt = [&]() {
+        for (size_t i = 0; i < orphans.size(); i++) {
+            int p = orphans[i];
+            char side = tree[p];
+            int x = p % sizeX;
+            int y = p / sizeX % sizeY;
+            int z = p / (sizeX * sizeY);
+
+            int bestDirection = ORPHAN;
+            int bestDistance = INFINITE_DISTANCE;
+
+            for (int k = 0; k < directions; k++) {
+                int q = neighborAt(p, x, y, z, k);
+                if (q == -1 || tree[q] != side) {
+                    continue;
+                }
+                int arc = side == SOURCE_TREE ? residual[directions - 1 - k][q] : residual[k][p];
+                if (arc == 0) {
+                    continue;
+                }
+
+                // Поднимаемся от q до терминала или до вершины с актуальным расстоянием
+                int d = 0;
+                int r = q;
+                while (true) {
+                    if (timestamp[r] == time) {
+                        d += distance[r];
+                        break;
+                    }
+                    d++;
+                    if (parent[r] == TERMINAL) {
+                        timestamp[r] = time;
+                        distance[r] = 1;
+                        break;
+                    }
+                    if (parent[r] == ORPHAN) {
+                        d = INFINITE_DISTANCE;
+                        break;
+                    }
+                    r += offsets[parent[r]].step;
+                }
+
+                if (d == INFINITE_DISTANCE) {
+                    continue;
+                }
+                if (d < bestDistance) {
+                    bestDirection = k;
+                    bestDistance = d;
+                }
+
+                // Кешируем расстояния на пройденном пути
+                for (r = q; timestamp[r] != time; r += offsets[parent[r]].step) {
+                    timestamp[r] = time;
+                    distance[r] = d--;
+                }
+            }
+
+            if (bestDirection != ORPHAN) {
+                parent[p] = bestDirection;
+                timestamp[p] = time;
+                distance[p] = bestDistance + 1;
+                continue;
+            }
+
+            // Родителя нет: вершина становится свободной, ее дети - сиротами,
+            // а соседи, способные ее подхватить, - активными
+            tree[p] = FREE;
+            for (int k = 0; k < directions; k++) {
+                int q = neighborAt(p, x, y, z, k);
+                if (q == -1 || tree[q] != side) {
+                    continue;
+                }
+                int arc = side == SOURCE_TREE ? residual[directions - 1 - k][q] : residual[k][p];
+                if (arc > 0) {
+                    activate(q);
+                }
+                if (parent[q] == directions - 1 - k) {
+                    makeOrphan(q);
+                }
+            }
+        }
+        orphans.clear();
+        };
+
+    // Рост деревьев, увеличения и усыновления чередуются слишком часто для отдельных интервалов
+    TraceSpan searchSpan("gridMaxFlow", "search");
+    while (activeHead < activeQueue.size()) {
+        int p = activeQueue[activeHead++];
+        isActive[p] = 0;
+        if (activeHead == activeQueue.size()) {
+            activeQueue.clear();
+            activeHead = 0;
+        }
+        if (tree[p] == FREE) {
+            continue;
+        }
+
+        // Рост дерева: захватываем свободных соседей, пока не встретим другое дерево
+        int x = p % sizeX;
+        int y = p / sizeX % sizeY;
+        int z = p / (sizeX * sizeY);
+        bool augmented = false;
+
+        for (int k = 0; k < directions && !augmented; k++) {
+            int q = neighborAt(p, x, y, z, k);
+            if (q == -1) {
+                continue;
+            }
+            int back = directions - 1 - k;
+
+            if (tree[p] == SOURCE_TREE) {
+                if (residual[k][p] == 0) {
+                    continue;
+                }
+                if (tree[q] == FREE) {
+                    tree[q] = SOURCE_TREE;
+                    parent[q] = back;
+                    timestamp[q] = timestamp[p];
+                    distance[q] = distance[p] + 1;
+                    activate(q);
+                }
+                else if (tree[q] == SINK_TREE) {
+                    time++;
+                    augment(p, q, k);
+                    augmented = true;
+                }
+                else if (timestamp[q] <= timestamp[p] && distance[q] > distance[p]) {
+                    parent[q] = back;
+                    timestamp[q] = timestamp[p];
+                    distance[q] = distance[p] + 1;
+                }
+            }
+            else {
+                if (residual[back][q] == 0) {
+                    continue;
+                }
+                if (tree[q] == FREE) {
+                    tree[q] = SINK_TREE;
+                    parent[q] = back;
+                    timestamp[q] = timestamp[p];
+                    distance[q] = distance[p] + 1;
+                    activate(q);
+                }
+                else if (tree[q] == SOURCE_TREE) {
+                    time++;
+                    augment(q, p, back);
+                    augmented = true;
+                }
+                else if (timestamp[q] <= timestamp[p] && distance[q] > distance[p]) {
+                    parent[q] = back;
+                    timestamp[q] = timestamp[p];
+                    distance[q] = distance[p] + 1;
+                }
+            }
+        }
+
+        if (augmented) {
+            adopt();
+            // Вершина могла найти еще пути - возвращаем ее в очередь
+            if (tree[p] != FREE) {
+                activate(p);
+            }
+        }
+    }
+
+    searchSpan.annotate("augmentations", augmentations);
+    searchSpan.end();
+
+    // Сторона источника минимального разреза - дерево источника
+    if (sourceSide) {
+        for (int p = 0; p < n; p++) {
+            (*sourceSide)[p] = tree[p] == SOURCE_TREE;
+        }
+    }
+
+    return maxFlow;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+
+// Связность решетки: 4 и 8 - соседи в плоскости слоя, 6 и 26 - объемные соседи
+enum GridConnectivity {
+    Grid4 = 4,
+    Grid8 = 8,
+    Grid6 = 6,
+    Grid26 = 26
+};
+
+// Неявный граф-решетка width x height x depth (depth = 1 для изображений).
+// Соседи пикселя вычисляются по координатам, списков смежности нет: для каждого направления
+// хранится плотный массив пропускных способностей дуг "пиксель -> сосед в этом направлении",
+// для терминалов - массивы пропускных способностей из источника и в сток по пикселям.
+// Направления упорядочены так, что противоположное направлению k - это directionCount() - 1 - k.
+class GridGraph {
+public:
+    GridGraph(int width, int height, int depth, GridConnectivity connectivity);
+
+    int width() const {
+        return sizeX;
+    }
+
+    int height() const {
+        return sizeY;
+    }
+
+    int depth() const {
+        return sizeZ;
+    }
+
+    int pixelCount() const {
+        return sizeX * sizeY * sizeZ;
+    }
+
+    int directionCount() const {
+        return (int)offsets.size();
+    }
+
+    int opposite(int direction) const {
+        return directionCount() - 1 - direction;
+    }
+
+    int pixelIndex(int x, int y, int z = 0) const {
+        return (z * sizeY + y) * sizeX + x;
+    }
+
+    // Сосед пикселя в направлении direction или -1, если он за границей решетки
+    int neighbor(int pixel, int direction) const;
+
+    // Пропускная способность дуги pixel -> neighbor(pixel, direction)
+    void setCapacity(int pixel, int direction, int capacity) {
+        capacities[direction][pixel] = capacity;
+    }
+
+    int capacity(int pixel, int direction) const {
+        return capacities[direction][pixel];
+    }
+
+    void setTerminalCapacities(int pixel, int sourceCapacity, int sinkCapacity) {
+        sourceCapacities[pixel] = sourceCapacity;
+        sinkCapacities[pixel] = sinkCapacity;
+    }
+
+    int sourceCapacity(int pixel) const {
+        return sourceCapacities[pixel];
+    }
+
+    int sinkCapacity(int pixel) const {
+        return sinkCapacities[pixel];
+    }
+
+private:
+    friend long long gridMaxFlow(const GridGraph& grid, std::vector<char>* sourceSide);
+
+    struct Offset {
+        int dx;
+        int dy;
+        int dz;
+        int step;
+    };
+
+    int sizeX;
+    int sizeY;
+    int sizeZ;
+    std::vector<Offset> offsets;
+    std::vector<std::vector<int>> capacities;
+    std::vector<int> sourceCapacities;
+    std::vector<int> sinkCapacities;
+};
+
+// Алгоритм Бойкова-Колмогорова прямо на решетке: деревья поиска из источника и стока,
+// родитель пикселя хранится как направление, сосед - смещение индекса, остаточные
+// пропускные способности - копии массивов направлений.
+// Возвращает величину максимального потока; если sourceSide задан, в него записывается
+// признак стороны источника минимального разреза для каждого пикселя.
+long long gridMaxFlow(const GridGraph& grid, std::vector<char>* sourceSide = nullptr);
@@ -0,0 +1,379 @@
+#include "LinkCutDinic.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+namespace {
+
+// Лес с корнями, представленный splay-деревьями путей. Значение вершины - остаточная
+// пропускная способность дуги к ее родителю; у корня дерева значение "бесконечно".
+// Поддерживаются минимум на пути до корня (с вершиной, где он достигается) и прибавление к пути.
+class LinkCutForest {
+public:
+    explicit LinkCutForest(int n)
+        : parent(n, -1), left(n, -1), right(n, -1), value(n, INF), minValue(n, INF), minNode(n), lazy(n, 0) {
+        for (int v = 0; v < n; v++) {
+            minNode[v] = v;
+        }
+    }
+
+    static constexpr long long INF = LLONG_MAX / 4;
+
+    // Корень дерева, содержащего v
+    int findRoot(int v) {
+        access(v);
+        int root = v;
+        while (true) {
+            push(root);
+            if (left[root] == -1) {
+                break;
+            }
+            root = left[root];
+        }
+        splay(root);
+        return root;
+    }
+
+    // Минимальное значение на пути от v до корня; вершина с минимумом - в node
+    long long pathMin(int v, int& node) {
+        access(v);
+        node = minNode[v];
+        return minValue[v];
+    }
+
+    // Прибавляет delta ко всем значениям на пути от v до корня
+    void pathAdd(int v, long long delta) {
+        access(v);
+        apply(v, delta);
+    }
+
+    // Подвешивает корень v к вершине w со значением capacity
+    void link(int v, int w, long long capacity) {
+        access(v);
+        value[v] = capacity;
+        pull(v);
+        parent[v] = w;
+    }
+
+    // Отрезает v от родителя; возвращает значение v перед отрезанием
+    long long cut(int v) {
+        access(v);
+        long long remaining = value[v];
+        if (left[v] != -1) {
+            parent[left[v]] = -1;
+            left[v] = -1;
+        }
+        value[v] = INF;
+        pull(v);
+        return remaining;
+    }
+
+private:
+    bool isSplayRoot(int x) const {
+        int p = parent[x];
+        return p == -1 || (left[p] != x && right[p] != x);
+    }
+
+    void apply(int x, long long delta) {
+        if (x != -1) {
+            value[x] += delta;
+            minValue[x] += delta;
+            lazy[x] += delta;
+        }
+    }
+
+    void push(int x) {
+        if (lazy[x] != 0) {
+            apply(left[x], lazy[x]);
+            apply(right[x], lazy[x]);
+            lazy[x] = 0;
+        }
+    }
+
+    void pull(int x) {
+        minValue[x] = value[x];
+        minNode[x] = x;
+        for (int c : { left[x], right[x] }) {
+            if (c != -1 && minValue[c] < minValue[x]) {
+                minValue[x] = minValue[c];
+                minNode[x] = minNode[c];
+            }
+        }
+    }
+
+    void rotate(int x) {
+        int p = parent[x];
+        int g = parent[p];
+        bool pIsRoot = isSplayRoot(p);
+
+        if (left[p] == x) {
+            left[p] = right[x];
+            if (right[x] != -1) {
+                parent[right[x]] = p;
+            }
+            right[x] = p;
+        }
+        else {
+            right[p] = left[x];
+            if (left[x] != -1) {
+                parent[left[x]] = p;
+            }
+            left[x] = p;
+        }
+
+        parent[p] = x;
+        parent[x] = g;
+        if (!pIsRoot) {
+            if (left[g] == p) {
+                left[g] = x;
+            }
+            else {
+                right[g] = x;
+            }
+        }
+
+        pull(p);
+        pull(x);
+    }
+
+    void splay(int x) {
+        // Отложенные прибавления проталкиваются сверху вниз до x
+        stack.clear();
+        for (int y = x; ; y = parent[y]) {
+            stack.push_back(y);
+            if (isSplayRoot(y)) {
+                break;
+            }
+        }
+        for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+            push(*it);
+        }
+
+        while (!isSplayRoot(x)) {
+            int p = parent[x];
+            if (!isSplayRoot(p)) {
+                int g = parent[p];
+                bool zigZig = (left[g] == p) == (left[p] == x);
+                rotate(zigZig ? p : x);
+            }
+            rotate(x);
+        }
+    }
+
+    // После вызова путь от корня дерева до v - одно splay-дерево с v в вершине и без правого поддерева
+    void access(int v) {
+        int last = -1;
+        for (int x = v; x != -1; x = parent[x]) {
+            splay(x);
+            right[x] = last;
+            pull(x);
+            last = x;
+        }
+        splay(v);
+    }
+
+    vector<int> parent;
+    vector<int> left;
+    vector<int> right;
+    vector<long long> value;
+    vector<long long> minValue;
+    vector<int> minNode;
+    vector<long long> lazy;
+    vector<int> stack;
+};
+
+// Определение нужно до C++17: INF передается в конструктор vector по ссылке
+constexpr long long LinkCutForest::INF;
+
+}
+
+int linkCutDinic(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
+    // Проверка входных данных
+    if (graph.empty()) {
+        return 0;
+    }
+
+    if (graph.find(sourceId) == graph.end()) {
+        return 0;
+    }
+
+    if (graph.find(sinkId) == graph.end()) {
+        return 0;
+    }
+
+    if (sourceId == sinkId) {
+        return 0;
+    }
+
+    TraceSpan solveSpan("linkCutDinic", "solve");
+    TraceSpan convertSpan("linkCutDinic", "convert");
+
+    // Сопоставляем ID вершинам индексы
+    unordered_map<int, int> nodeIdToIndex;
+    int n = 0;
+    for (auto& pair : graph) {
+        nodeIdToIndex[pair.first] = n++;
+    }
+
+    // Остаточная сеть (CSR): прямая дуга несет вес ребра, обратная - ноль
+    // (у неориентированного ребра - тоже вес ребра)
+    vector<int> firstArc(n + 1, 0);
+    for (auto& pair : graph) {
+        int u = nodeIdToIndex[pair.first];
+        for (Edge* edge : pair.second->edges) {
+            firstArc[u + 1]++;
+            firstArc[nodeIdToIndex[edge->adjacentNode->id] + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        firstArc[u + 1] += firstArc[u];
+    }
+
+    int m = firstArc[n];
+    vector<int> arcTo(m);
+    vector<int> arcRev(m);
+    vector<int> capacity(m);
+    vector<Edge*> arcEdge(m, nullptr);
+
+    vector<int> pos(firstArc.begin(), firstArc.end() - 1);
+    for (auto& pair : graph) {
+        int u = nodeIdToIndex[pair.first];
+        for (Edge* edge : pair.second->edges) {
+            int v = nodeIdToIndex[edge->adjacentNode->id];
+            int forward = pos[u]++;
+            int backward = pos[v]++;
+
+            arcTo[forward] = v;
+            arcRev[forward] = backward;
+            capacity[forward] = edge->weight;
+            arcEdge[forward] = edge;
+
+            arcTo[backward] = u;
+            arcRev[backward] = forward;
+            capacity[backward] = edge->undirected ? edge->weight : 0;
+        }
+    }
+
+    int source = nodeIdToIndex[sourceId];
+    int sink = nodeIdToIndex[sinkId];
+
+    vector<int> level(n);
+    vector<int> ptr(n);
+    vector<int> bfsQueue(n);
+    vector<int> parentArc(n, -1);
+    LinkCutForest forest(n);
+    convertSpan.end();
+
+    // BFS для построения слоистой сети
+    auto bfs = [&]() -> bool {
+        TraceSpan span("linkCutDinic", "bfs");
+        fill(level.begin(), level.end(), -1);
+        int tail = 0;
+        bfsQueue[tail++] = source;
+        level[source] = 0;
+
+        for (int head = 0; head < tail; head++) {
+            int u = bfsQueue[head];
+            for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+                if (capacity[a] > 0 && level[arcTo[a]] == -1) {
+                    level[arcTo[a]] = level[u] + 1;
+                    bfsQueue[tail++] = arcTo[a];
+                }
+            }
+        }
+
+        return level[sink] != -1;
+        };
+
+    // Отрезает v от родителя и переносит накопленный в дереве поток в остаточную сеть
+    auto cutTree = [&](int v) {
+        int arc = parentArc[v];
+        int remaining = (int)forest.cut(v);
+        capacity[arcRev[arc]] += capacity[arc] - remaining;
+        capacity[arc] = remaining;
+        parentArc[v] = -1;
+        };
+
+    int maxFlow = 0;
+
+    while (bfs()) {
+        TraceSpan blockingSpan("linkCutDinic", "blocking flow");
+        int phaseStart = maxFlow;
+        for (int u = 0; u < n; u++) {
+            ptr[u] = firstArc[u];
+        }
+
+        while (true) {
+            int v = forest.findRoot(source);
+
+            if (v == sink) {
+                // Путь от источника до стока собран целиком - проталкиваем по нему минимум
+                int node;
+                long long pushed = forest.pathMin(source, node);
+                forest.pathAdd(source, -pushed);
+                maxFlow += (int)pushed;
+
+                while (forest.pathMin(source, node) == 0) {
+                    cutTree(node);
+                }
+                continue;
+            }
+
+            // Ищем допустимую дугу из корня текущего дерева
+            int& a = ptr[v];
+            while (a < firstArc[v + 1] && !(capacity[a] > 0 && level[arcTo[a]] == level[v] + 1)) {
+                a++;
+            }
+
+            if (a < firstArc[v + 1]) {
+                forest.link(v, arcTo[a], capacity[a]);
+                parentArc[v] = a;
+                continue;
+            }
+
+            // Тупик: вершина исключается из слоистой сети вместе с дугами, ведущими в нее
+            if (v == source) {
+                break;
+            }
+            level[v] = -1;
+            for (int b = firstArc[v]; b < firstArc[v + 1]; b++) {
+                int child = arcTo[b];
+                if (parentArc[child] == arcRev[b]) {
+                    cutTree(child);
+                }
+            }
+        }
+
+        blockingSpan.annotate("pushed", maxFlow - phaseStart);
+        blockingSpan.end();
+
+        // Конец фазы: переносим поток со всех оставшихся дуг леса
+        TraceSpan cleanupSpan("linkCutDinic", "cleanup");
+        for (int v = 0; v < n; v++) {
+            if (parentArc[v] != -1) {
+                cutTree(v);
+            }
+        }
+    }
+
+    CertificateHook hook = getCertificateHook();
+    if (hook) {
+        TraceSpan span("linkCutDinic", "certificate");
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        for (int a = 0; a < m; a++) {
+            if (arcEdge[a]) {
+                certificate.edgeFlow[arcEdge[a]] = arcEdge[a]->weight - capacity[a];
+            }
+        }
+        buildResidualCut(graph, sourceId, certificate);
+        hook("linkCutDinic", graph, sourceId, sinkId, certificate);
+    }
+
+    return maxFlow;
+}
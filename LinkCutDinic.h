@@ -0,0 +1,10 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+
+// Алгоритм Диница, где блокирующий поток ищется на динамических деревьях Слейтора-Тарьяна (link-cut).
+// Лес допустимых дуг хранится в link-cut дереве: минимум и вычитание потока на пути до корня
+// выполняются за O(log V) амортизированно, насыщенные дуги отрезаются. Фаза - O(E log V),
+// весь алгоритм - O(V E log V); выгоден на длинных узких слоистых сетях.
+int linkCutDinic(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId);
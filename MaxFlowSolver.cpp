@@ -0,0 +1,241 @@
+#include "MaxFlowSolver.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+MaxFlowSolver::MaxFlowSolver(unordered_map<int, Node*>& graph)
+    : graph(graph), n(graph.size()), bfsSize(0), phaseStamp(0), solveStamp(0) {
+    TraceSpan span("MaxFlowSolver", "convert");
+
+    // Сопоставляем ID вершинам индексы
+    int index = 0;
+    for (auto& pair : graph) {
+        nodeIdToIndex[pair.first] = index++;
+    }
+
+    // Строим остаточную сеть: прямая дуга несет вес ребра, обратная - ноль
+    // (у неориентированного ребра - тоже вес ребра, см. reloadCapacities)
+    firstArc.assign(n + 1, 0);
+    for (auto& pair : graph) {
+        int u = nodeIdToIndex[pair.first];
+        for (Edge* edge : pair.second->edges) {
+            firstArc[u + 1]++;
+            firstArc[nodeIdToIndex[edge->adjacentNode->id] + 1]++;
+        }
+    }
+    for (int u = 0; u < n; u++) {
+        firstArc[u + 1] += firstArc[u];
+    }
+
+    int m = firstArc[n];
+    arcTo.assign(m, 0);
+    arcRev.assign(m, 0);
+    arcEdge.assign(m, nullptr);
+
+    vector<int> pos(firstArc.begin(), firstArc.end() - 1);
+    for (auto& pair : graph) {
+        int u = nodeIdToIndex[pair.first];
+        for (Edge* edge : pair.second->edges) {
+            int v = nodeIdToIndex[edge->adjacentNode->id];
+            int forward = pos[u]++;
+            int backward = pos[v]++;
+
+            arcTo[forward] = v;
+            arcRev[forward] = backward;
+            arcEdge[forward] = edge;
+
+            arcTo[backward] = u;
+            arcRev[backward] = forward;
+        }
+    }
+
+    capacity.assign(m, 0);
+    initialCapacity.assign(m, 0);
+    reloadCapacities();
+
+    // Все рабочие массивы выделяются один раз под максимальный размер
+    level.assign(n, 0);
+    levelStamp.assign(n, 0);
+    ptr.assign(n, 0);
+    bfsQueue.assign(n, 0);
+    pathArcs.assign(n, 0);
+    arcStamp.assign(m, 0);
+    touchedArcs.reserve(m);
+}
+
+void MaxFlowSolver::reloadCapacities() {
+    // Обратная дуга пустая, у неориентированного ребра - с тем же весом
+    for (size_t a = 0; a < arcEdge.size(); a++) {
+        if (arcEdge[a]) {
+            initialCapacity[a] = arcEdge[a]->weight;
+            initialCapacity[arcRev[a]] = arcEdge[a]->undirected ? arcEdge[a]->weight : 0;
+        }
+    }
+    capacity = initialCapacity;
+    touchedArcs.clear();
+}
+
+void MaxFlowSolver::touchArc(int arc) {
+    if (arcStamp[arc] != solveStamp) {
+        arcStamp[arc] = solveStamp;
+        touchedArcs.push_back(arc);
+    }
+}
+
+void MaxFlowSolver::resetTouched() {
+    TraceSpan span("MaxFlowSolver", "cleanup");
+    span.annotate("arcs", (long long)touchedArcs.size());
+
+    for (int arc : touchedArcs) {
+        capacity[arc] = initialCapacity[arc];
+    }
+    touchedArcs.clear();
+
+    // При переполнении эпохи старые метки могли бы совпасть с новыми - сбрасываем их целиком
+    if (++solveStamp == 0) {
+        fill(arcStamp.begin(), arcStamp.end(), 0);
+        solveStamp = 1;
+    }
+}
+
+// BFS для построения слоистой сети; посещенные вершины остаются в bfsQueue[0, bfsSize)
+bool MaxFlowSolver::buildLevels(int source, int sink) {
+    TraceSpan span("MaxFlowSolver", "bfs");
+
+    if (++phaseStamp == 0) {
+        fill(levelStamp.begin(), levelStamp.end(), 0);
+        phaseStamp = 1;
+    }
+
+    bfsSize = 0;
+    bfsQueue[bfsSize++] = source;
+    levelStamp[source] = phaseStamp;
+    level[source] = 0;
+
+    for (int head = 0; head < bfsSize; head++) {
+        int u = bfsQueue[head];
+        ptr[u] = firstArc[u];
+
+        for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+            int v = arcTo[a];
+            if (capacity[a] > 0 && levelStamp[v] != phaseStamp) {
+                levelStamp[v] = phaseStamp;
+                level[v] = level[u] + 1;
+                bfsQueue[bfsSize++] = v;
+            }
+        }
+    }
+
+    return levelStamp[sink] == phaseStamp;
+}
+
+// Блокирующий поток итеративным обходом в глубину по указателям ptr
+int MaxFlowSolver::blockingFlow(int source, int sink) {
+    TraceSpan span("MaxFlowSolver", "blocking flow");
+    int total = 0;
+    int depth = 0;
+    int u = source;
+
+    while (true) {
+        if (u == sink) {
+            int pushed = INT_MAX;
+            for (int i = 0; i < depth; i++) {
+                pushed = min(pushed, capacity[pathArcs[i]]);
+            }
+
+            // Проталкиваем поток и откатываемся к началу первой насыщенной дуги
+            int firstSaturated = -1;
+            for (int i = 0; i < depth; i++) {
+                int a = pathArcs[i];
+                capacity[a] -= pushed;
+                capacity[arcRev[a]] += pushed;
+                touchArc(a);
+                touchArc(arcRev[a]);
+
+                if (capacity[a] == 0 && firstSaturated == -1) {
+                    firstSaturated = i;
+                }
+            }
+
+            total += pushed;
+            depth = firstSaturated;
+            u = depth == 0 ? source : arcTo[pathArcs[depth - 1]];
+            continue;
+        }
+
+        int& i = ptr[u];
+        while (i < firstArc[u + 1]) {
+            int v = arcTo[i];
+            if (capacity[i] > 0 && levelStamp[v] == phaseStamp && level[v] == level[u] + 1) {
+                break;
+            }
+            i++;
+        }
+
+        if (i < firstArc[u + 1]) {
+            pathArcs[depth++] = i;
+            u = arcTo[i];
+            continue;
+        }
+
+        // Тупик: исключаем вершину из слоистой сети и возвращаемся на шаг назад
+        if (u == source) {
+            break;
+        }
+        levelStamp[u] = 0;
+        depth--;
+        u = depth == 0 ? source : arcTo[pathArcs[depth - 1]];
+        ptr[u]++;
+    }
+
+    span.annotate("pushed", total);
+    return total;
+}
+
+int MaxFlowSolver::solve(int sourceId, int sinkId) {
+    // Проверка входных данных
+    auto sourceIt = nodeIdToIndex.find(sourceId);
+    auto sinkIt = nodeIdToIndex.find(sinkId);
+    if (sourceIt == nodeIdToIndex.end() || sinkIt == nodeIdToIndex.end()) {
+        return 0;
+    }
+
+    if (sourceId == sinkId) {
+        return 0;
+    }
+
+    TraceSpan span("MaxFlowSolver", "solve");
+    resetTouched();
+
+    int source = sourceIt->second;
+    int sink = sinkIt->second;
+    int maxFlow = 0;
+
+    while (buildLevels(source, sink)) {
+        maxFlow += blockingFlow(source, sink);
+    }
+
+    if (getCertificateHook()) {
+        reportCertificate(sourceId, sinkId, maxFlow);
+    }
+
+    return maxFlow;
+}
+
+void MaxFlowSolver::reportCertificate(int sourceId, int sinkId, int maxFlow) {
+    TraceSpan span("MaxFlowSolver", "certificate");
+    FlowCertificate certificate;
+    certificate.flowValue = maxFlow;
+    for (size_t a = 0; a < arcEdge.size(); a++) {
+        if (arcEdge[a]) {
+            certificate.edgeFlow[arcEdge[a]] = initialCapacity[a] - capacity[a];
+        }
+    }
+    buildResidualCut(graph, sourceId, certificate);
+    getCertificateHook()("MaxFlowSolver", graph, sourceId, sinkId, certificate);
+}
\ No newline at end of file
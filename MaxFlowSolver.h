@@ -0,0 +1,50 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+#include <vector>
+
+// Переиспользуемый решатель (алгоритм Диница) с постоянными рабочими массивами.
+// Привязывается к графу один раз; повторные вызовы solve не выделяют память,
+// а состояние прошлого запуска сбрасывается только по затронутым дугам и вершинам.
+// Граф должен жить дольше решателя; после изменения весов ребер вызовите reloadCapacities.
+class MaxFlowSolver {
+public:
+    explicit MaxFlowSolver(std::unordered_map<int, Node*>& graph);
+
+    int solve(int sourceId, int sinkId);
+
+    // Перечитывает веса ребер привязанного графа (форма графа должна остаться прежней)
+    void reloadCapacities();
+
+private:
+    bool buildLevels(int source, int sink);
+    int blockingFlow(int source, int sink);
+    void touchArc(int arc);
+    void resetTouched();
+    void reportCertificate(int sourceId, int sinkId, int maxFlow);
+
+    std::unordered_map<int, Node*>& graph;
+    std::unordered_map<int, int> nodeIdToIndex;
+    int n;
+
+    // Остаточная сеть (CSR): дуги вершины u лежат в [firstArc[u], firstArc[u + 1])
+    std::vector<int> firstArc;
+    std::vector<int> arcTo;
+    std::vector<int> arcRev;
+    std::vector<int> capacity;
+    std::vector<int> initialCapacity;
+    std::vector<Edge*> arcEdge;
+
+    // Рабочие массивы; метки "посещена" и "изменена" сравниваются с текущей эпохой
+    std::vector<int> level;
+    std::vector<unsigned> levelStamp;
+    std::vector<int> ptr;
+    std::vector<int> bfsQueue;
+    int bfsSize;
+    std::vector<int> pathArcs;
+    std::vector<unsigned> arcStamp;
+    std::vector<int> touchedArcs;
+    unsigned phaseStamp;
+    unsigned solveStamp;
+};
\ No newline at end of file
@@ -0,0 +1,456 @@
+#include "ParametricMaxFlow.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Дуга параметрической сети: пропускная способность base + slope * lambda.
+// Неориентированная дуга (только постоянная, между внутренними вершинами) несет ее в обе стороны.
+struct ParametricArcInput {
+    int from;
+    int to;
+    double base;
+    double slope;
+    bool undirected;
+};
+
+// Первая фаза проталкивания предпотока, которую можно продолжать после роста lambda:
+// дуги из источника дополнительно насыщаются, поток по дугам в сток урезается до новой
+// пропускной способности, а высоты вершин остаются допустимыми и не сбрасываются.
+class ParametricPreflow {
+public:
+    ParametricPreflow(int n, int source, int sink, const vector<ParametricArcInput>& arcs,
+        double lambda, double eps)
+        : n(n), source(source), sink(sink), lambda(lambda), eps(eps),
+        firstArc(n + 1, 0), height(n, 0), excess(n, 0.0), current(n, 0) {
+        TraceSpan span("parametric", "convert");
+        for (const ParametricArcInput& a : arcs) {
+            firstArc[a.from + 1]++;
+            firstArc[a.to + 1]++;
+        }
+        for (int u = 0; u < n; u++) {
+            firstArc[u + 1] += firstArc[u];
+        }
+
+        int m = firstArc[n];
+        arcTo.assign(m, 0);
+        arcRev.assign(m, 0);
+        residual.assign(m, 0.0);
+
+        vector<int> pos(firstArc.begin(), firstArc.end() - 1);
+        for (const ParametricArcInput& a : arcs) {
+            int forward = pos[a.from]++;
+            int backward = pos[a.to]++;
+
+            arcTo[forward] = a.to;
+            arcRev[forward] = backward;
+            residual[forward] = a.base + a.slope * lambda;
+
+            arcTo[backward] = a.from;
+            arcRev[backward] = forward;
+            residual[backward] = a.undirected ? a.base : 0.0;
+
+            if (a.from == source && a.slope != 0) {
+                sourceArcs.push_back({ forward, a.slope });
+            }
+            else if (a.to == sink && a.slope != 0) {
+                sinkArcs.push_back({ forward, a.slope });
+            }
+        }
+
+        // Насыщаем все дуги из источника
+        height[source] = n;
+        for (int a = firstArc[source]; a < firstArc[source + 1]; a++) {
+            double flow = residual[a];
+            if (flow > 0) {
+                residual[a] = 0;
+                residual[arcRev[a]] += flow;
+                excess[arcTo[a]] += flow;
+            }
+        }
+    }
+
+    // Переход к большему значению параметра без сброса предпотока и меток
+    void setLambda(double newLambda) {
+        double delta = newLambda - lambda;
+        lambda = newLambda;
+
+        for (auto& arc : sourceArcs) {
+            double added = arc.second * delta;
+            residual[arcRev[arc.first]] += added;
+            excess[arcTo[arc.first]] += added;
+        }
+
+        for (auto& arc : sinkArcs) {
+            int a = arc.first;
+            double removed = -arc.second * delta;
+
+            if (residual[a] >= removed) {
+                residual[a] -= removed;
+                continue;
+            }
+
+            // Поток по дуге превышает новую пропускную способность - излишек возвращается в вершину
+            double returned = removed - residual[a];
+            int from = arcTo[arcRev[a]];
+            residual[a] = 0;
+            residual[arcRev[a]] -= returned;
+            excess[from] += returned;
+            excess[sink] -= returned;
+        }
+    }
+
+    void run() {
+        TraceSpan span("parametric", "discharge");
+        globalRelabel();
+
+        queue<int> active;
+        vector<char> isActive(n, 0);
+        auto activate = [&](int u) {
+            if (u != source && u != sink && excess[u] > eps && height[u] < n && !isActive[u]) {
+                isActive[u] = 1;
+                active.push(u);
+            }
+            };
+
+        for (int u = 0; u < n; u++) {
+            activate(u);
+        }
+
+        int relabels = 0;
+        while (!active.empty()) {
+            int u = active.front();
+            active.pop();
+            isActive[u] = 0;
+
+            while (excess[u] > eps && height[u] < n) {
+                for (; current[u] < firstArc[u + 1]; current[u]++) {
+                    int a = current[u];
+                    int v = arcTo[a];
+
+                    if (residual[a] > eps && height[u] == height[v] + 1) {
+                        double flow = min(excess[u], residual[a]);
+
+                        residual[a] -= flow;
+                        residual[arcRev[a]] += flow;
+                        excess[u] -= flow;
+                        excess[v] += flow;
+                        activate(v);
+
+                        if (excess[u] <= eps) {
+                            break;
+                        }
+                    }
+                }
+
+                if (excess[u] > eps) {
+                    // Подъем: минимальная высота среди соседей с остаточной пропускной способностью
+                    int minHeight = n;
+                    for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+                        if (residual[a] > eps) {
+                            minHeight = min(minHeight, height[arcTo[a]]);
+                        }
+                    }
+                    height[u] = min(n, minHeight + 1);
+                    current[u] = firstArc[u];
+
+                    // Периодическая глобальная перемаркировка
+                    if (++relabels > n) {
+                        relabels = 0;
+                        globalRelabel();
+                        for (int w = 0; w < n; w++) {
+                            activate(w);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Разметка для разреза: вершины с высотой n не достигают стока
+        globalRelabel();
+    }
+
+    double flowValue() const {
+        return excess[sink];
+    }
+
+    bool canReachSink(int u) const {
+        return height[u] < n;
+    }
+
+private:
+    // Точные расстояния до стока в остаточной сети; недостижимые вершины получают высоту n
+    void globalRelabel() {
+        TraceSpan span("parametric", "global relabel");
+        vector<int> distance(n, n);
+        distance[sink] = 0;
+
+        queue<int> q;
+        q.push(sink);
+        while (!q.empty()) {
+            int v = q.front();
+            q.pop();
+
+            for (int a = firstArc[v]; a < firstArc[v + 1]; a++) {
+                int u = arcTo[a];
+                if (u != source && distance[u] == n && residual[arcRev[a]] > eps) {
+                    distance[u] = distance[v] + 1;
+                    q.push(u);
+                }
+            }
+        }
+
+        // Высоты только растут: вершины, уже отрезанные от стока, там и остаются
+        for (int u = 0; u < n; u++) {
+            if (u != source) {
+                height[u] = max(height[u], distance[u]);
+            }
+            current[u] = firstArc[u];
+        }
+    }
+
+    int n;
+    int source;
+    int sink;
+    double lambda;
+    double eps;
+
+    vector<int> firstArc;
+    vector<int> arcTo;
+    vector<int> arcRev;
+    vector<double> residual;
+    vector<pair<int, double>> sourceArcs;
+    vector<pair<int, double>> sinkArcs;
+
+    vector<int> height;
+    vector<double> excess;
+    vector<int> current;
+};
+
+// Общая часть обоих режимов: индексы вершин, список дуг и проверка наклонов
+static bool buildParametricArcs(unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    const unordered_map<Edge*, int>& slope, unordered_map<int, int>& nodeIdToIndex,
+    vector<ParametricArcInput>& arcs) {
+    if (graph.empty()) {
+        return false;
+    }
+
+    if (graph.find(sourceId) == graph.end()) {
+        return false;
+    }
+
+    if (graph.find(sinkId) == graph.end()) {
+        return false;
+    }
+
+    if (sourceId == sinkId) {
+        return false;
+    }
+
+    int index = 0;
+    for (auto& pair : graph) {
+        nodeIdToIndex[pair.first] = index++;
+    }
+
+    int source = nodeIdToIndex[sourceId];
+    int sink = nodeIdToIndex[sinkId];
+
+    for (auto& pair : graph) {
+        int u = nodeIdToIndex[pair.first];
+
+        for (Edge* edge : pair.second->edges) {
+            int from = u;
+            int v = nodeIdToIndex[edge->adjacentNode->id];
+            auto it = slope.find(edge);
+            int edgeSlope = it == slope.end() ? 0 : it->second;
+
+            // У источника и стока неориентированное ребро работает только в одну сторону
+            if (edge->undirected && (v == source || from == sink)) {
+                swap(from, v);
+            }
+            bool undirected = edge->undirected && from != source && v != sink;
+
+            // Монотонность: дуги из источника растут, дуги в сток убывают, остальные постоянны
+            if (from == source ? edgeSlope < 0 : (v == sink ? edgeSlope > 0 : edgeSlope != 0)) {
+                return false;
+            }
+
+            if (from != v) {
+                arcs.push_back({ from, v, (double)edge->weight, (double)edgeSlope, undirected });
+            }
+        }
+    }
+
+    return true;
+}
+
+static double parametricEpsilon(const vector<ParametricArcInput>& arcs, double lambdaMagnitude) {
+    double maxCapacity = 0;
+    for (const ParametricArcInput& a : arcs) {
+        maxCapacity = max(maxCapacity, fabs(a.base) + fabs(a.slope) * lambdaMagnitude);
+    }
+    return 1e-9 * (1 + maxCapacity);
+}
+
+vector<double> parametricMaxFlow(unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    const unordered_map<Edge*, int>& slope, const vector<double>& lambdas) {
+    TraceSpan solveSpan("parametricMaxFlow", "solve");
+    vector<double> flows(lambdas.size(), 0.0);
+
+    unordered_map<int, int> nodeIdToIndex;
+    vector<ParametricArcInput> arcs;
+    if (lambdas.empty() || !buildParametricArcs(graph, sourceId, sinkId, slope, nodeIdToIndex, arcs)) {
+        return flows;
+    }
+
+    double lambdaMagnitude = 0;
+    for (double lambda : lambdas) {
+        lambdaMagnitude = max(lambdaMagnitude, fabs(lambda));
+    }
+    double eps = parametricEpsilon(arcs, lambdaMagnitude);
+
+    int n = graph.size();
+    int source = nodeIdToIndex[sourceId];
+    int sink = nodeIdToIndex[sinkId];
+
+    ParametricPreflow preflow(n, source, sink, arcs, lambdas[0], eps);
+    double lastLambda = lambdas[0];
+
+    for (size_t i = 0; i < lambdas.size(); i++) {
+        // Продолжать предпоток можно только при росте параметра, иначе начинаем заново
+        if (lambdas[i] < lastLambda) {
+            preflow = ParametricPreflow(n, source, sink, arcs, lambdas[i], eps);
+        }
+        else {
+            preflow.setLambda(lambdas[i]);
+        }
+        lastLambda = lambdas[i];
+
+        preflow.run();
+        flows[i] = preflow.flowValue();
+    }
+
+    return flows;
+}
+
+vector<ParametricBreakpoint> parametricBreakpoints(unordered_map<int, Node*>& graph,
+    int sourceId, int sinkId, const unordered_map<Edge*, int>& slope,
+    double lambdaMin, double lambdaMax) {
+    TraceSpan solveSpan("parametricBreakpoints", "solve");
+    vector<ParametricBreakpoint> breakpoints;
+
+    unordered_map<int, int> nodeIdToIndex;
+    vector<ParametricArcInput> arcs;
+    if (lambdaMin > lambdaMax || !buildParametricArcs(graph, sourceId, sinkId, slope, nodeIdToIndex, arcs)) {
+        return breakpoints;
+    }
+
+    int n = graph.size();
+    int source = nodeIdToIndex[sourceId];
+    int sink = nodeIdToIndex[sinkId];
+    double eps = parametricEpsilon(arcs, max(fabs(lambdaMin), fabs(lambdaMax)));
+
+    // Разрез задается стороной источника; его величина линейна по lambda: A + B * lambda
+    auto cutLine = [&](const vector<char>& inSource) {
+        pair<double, double> line = { 0.0, 0.0 };
+        for (const ParametricArcInput& a : arcs) {
+            if ((inSource[a.from] && !inSource[a.to]) || (a.undirected && inSource[a.to] && !inSource[a.from])) {
+                line.first += a.base;
+                line.second += a.slope;
+            }
+        }
+        return line;
+        };
+
+    // Минимальный разрез при lambda среди разрезов S с lower <= S <= upper: lower стягивается
+    // в источник, все вне upper - в сток, задача решается только на оставшихся вершинах
+    auto solveCut = [&](double lambda, const vector<char>& lower, const vector<char>& upper) {
+        TraceSpan span("parametricBreakpoints", "solve cut");
+        vector<int> local(n);
+        int localCount = 2;
+        for (int u = 0; u < n; u++) {
+            local[u] = lower[u] ? 0 : (!upper[u] ? 1 : localCount++);
+        }
+
+        vector<ParametricArcInput> localArcs;
+        for (const ParametricArcInput& a : arcs) {
+            int from = local[a.from];
+            int to = local[a.to];
+            if (a.undirected && (to == 0 || from == 1)) {
+                swap(from, to);
+            }
+            if (from != to && from != 1 && to != 0 && !(from == 0 && to == 1)) {
+                localArcs.push_back({ from, to, a.base, a.slope, a.undirected && from != 0 && to != 1 });
+            }
+        }
+
+        ParametricPreflow preflow(localCount, 0, 1, localArcs, lambda, eps);
+        preflow.run();
+
+        vector<char> inSource(lower);
+        for (int u = 0; u < n; u++) {
+            if (local[u] >= 2 && !preflow.canReachSink(local[u])) {
+                inSource[u] = 1;
+            }
+        }
+        return inSource;
+        };
+
+    vector<char> everything(n, 1);
+    vector<char> onlySource(n, 0);
+    everything[sink] = 0;
+    onlySource[source] = 1;
+
+    struct Interval {
+        double lambdaLow;
+        vector<char> cutLow;
+        double lambdaHigh;
+        vector<char> cutHigh;
+    };
+
+    // Метод Эйснера-Северанса: пересечение прямых двух разрезов либо лежит на функции
+    // минимального разреза (это точка излома), либо дает новый вложенный разрез
+    vector<Interval> pending;
+    pending.push_back({ lambdaMin, solveCut(lambdaMin, onlySource, everything),
+        lambdaMax, solveCut(lambdaMax, onlySource, everything) });
+
+    while (!pending.empty()) {
+        Interval interval = move(pending.back());
+        pending.pop_back();
+
+        if (interval.cutLow == interval.cutHigh) {
+            continue;
+        }
+
+        pair<double, double> low = cutLine(interval.cutLow);
+        pair<double, double> high = cutLine(interval.cutHigh);
+        if (low.second - high.second <= eps) {
+            continue;
+        }
+
+        double lambda = (high.first - low.first) / (low.second - high.second);
+        lambda = min(max(lambda, interval.lambdaLow), interval.lambdaHigh);
+        double lineValue = low.first + low.second * lambda;
+
+        vector<char> cut = solveCut(lambda, interval.cutLow, interval.cutHigh);
+        pair<double, double> middle = cutLine(cut);
+        double cutValue = middle.first + middle.second * lambda;
+
+        if (cutValue >= lineValue - eps * n || cut == interval.cutLow || cut == interval.cutHigh) {
+            breakpoints.push_back({ lambda, lineValue });
+            continue;
+        }
+
+        pending.push_back({ interval.lambdaLow, interval.cutLow, lambda, cut });
+        pending.push_back({ lambda, cut, interval.lambdaHigh, interval.cutHigh });
+    }
+
+    sort(breakpoints.begin(), breakpoints.end(),
+        [](const ParametricBreakpoint& a, const ParametricBreakpoint& b) { return a.lambda < b.lambda; });
+
+    return breakpoints;
+}
\ No newline at end of file
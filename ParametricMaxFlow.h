@@ -0,0 +1,32 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+#include <vector>
+
+// Параметрическая сеть (Gallo-Grigoriadis-Tarjan): пропускная способность ребра e при параметре lambda
+// равна e->weight + slope[e] * lambda. Наклон ребер из источника должен быть >= 0, ребер в сток <= 0,
+// остальных ребер - 0 (отсутствующие в slope ребра имеют нулевой наклон). Вызывающий гарантирует
+// неотрицательность пропускных способностей на всем рассматриваемом диапазоне lambda.
+
+struct ParametricBreakpoint {
+    double lambda;
+    double cutValue;
+};
+
+// Максимальный поток для каждого значения из lambdas (по возрастанию). Предпоток и метки
+// переиспользуются между значениями, поэтому вся серия стоит примерно одного запуска
+// плюс глобальная перемаркировка O(V + E) на каждое значение. Убывание lambda начинает расчет заново.
+// При некорректных входных данных возвращаются нули.
+std::vector<double> parametricMaxFlow(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    const std::unordered_map<Edge*, int>& slope, const std::vector<double>& lambdas);
+
+// Все точки излома функции минимального разреза на [lambdaMin, lambdaMax] методом Эйснера-Северанса.
+// Предпоток между шагами не переиспользуется: каждый шаг - отдельный запуск на подграфе, где
+// уже известные стороны разреза стянуты в источник и сток. Подграфы одного уровня рекурсии
+// не пересекаются по вершинам, так что уровень стоит не больше одного запуска на всем графе,
+// но глубина рекурсии в худшем случае равна числу точек излома k: всего до O(k) запусков
+// максимального потока плюс O(V + E) на стягивание в каждом шаге.
+std::vector<ParametricBreakpoint> parametricBreakpoints(std::unordered_map<int, Node*>& graph,
+    int sourceId, int sinkId, const std::unordered_map<Edge*, int>& slope,
+    double lambdaMin, double lambdaMax);
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "Pseudoflow.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// Дуга остаточной сети для алгоритма псевдопотока (Хохбаум, вариант HPF с наибольшей меткой)
+struct PseudoflowArc {
+    int to;
+    int capacity;
+    int rev;
+
+    PseudoflowArc(int t, int c, int r) : to(t), capacity(c), rev(r) {}
+};
+
+int pseudoflowMinCut(unordered_map<int, Node*>& graph, int sourceId, int sinkId, vector<int>& sourceSide) {
+    sourceSide.clear();
+
+    // Проверка входных данных
+    if (graph.empty()) {
+        return 0;
+    }
+
+    if (graph.find(sourceId) == graph.end()) {
+        return 0;
+    }
+
+    if (graph.find(sinkId) == graph.end()) {
+        return 0;
+    }
+
+    if (sourceId == sinkId) {
+        return 0;
+    }
+
+    TraceSpan solveSpan("pseudoflow", "solve");
+    TraceSpan convertSpan("pseudoflow", "convert");
+
+    // Сопоставляем ID вершинам индексы
+    unordered_map<int, int> nodeIdToIndex;
+    vector<int> indexToNodeId;
+    for (auto& pair : graph) {
+        nodeIdToIndex[pair.first] = indexToNodeId.size();
+        indexToNodeId.push_back(pair.first);
+    }
+
+    int n = graph.size();
+    int source = nodeIdToIndex[sourceId];
+    int sink = nodeIdToIndex[sinkId];
+
+    // Простая инициализация: дуги из источника и в сток насыщаются сразу,
+    // источник и сток из дальнейшей работы исключаются
+    vector<vector<PseudoflowArc>> residual(n);
+    vector<int> excess(n, 0);
+
+    for (auto& pair : graph) {
+        for (Edge* edge : pair.second->edges) {
+            int u = nodeIdToIndex[pair.first];
+            int v = nodeIdToIndex[edge->adjacentNode->id];
+            int capacity = edge->weight;
+
+            // Неориентированное ребро у источника или стока полезно только в одну сторону - разворачиваем
+            if (edge->undirected && (v == source || u == sink)) {
+                swap(u, v);
+            }
+
+            if (u == v || u == sink || v == source) {
+                continue;
+            }
+
+            if (u == source) {
+                if (v != sink) {
+                    excess[v] += capacity;
+                }
+                continue;
+            }
+
+            if (v == sink) {
+                excess[u] -= capacity;
+                continue;
+            }
+
+            residual[u].push_back(PseudoflowArc(v, capacity, residual[v].size()));
+            residual[v].push_back(PseudoflowArc(u, edge->undirected ? capacity : 0, residual[u].size() - 1));
+        }
+    }
+
+    // Нормализованное дерево: родитель, дуга к родителю, списки детей
+    vector<int> parent(n, -1);
+    vector<int> arcToParent(n, -1);
+    vector<int> firstChild(n, -1);
+    vector<int> nextSibling(n, -1);
+    vector<int> prevSibling(n, -1);
+    vector<int> nextScan(n, -1);
+    vector<int> currentArc(n, 0);
+
+    // Метки: слабые вершины стартуют с 0, сильные с 1; метка n означает сторону источника
+    vector<int> label(n, 0);
+    vector<int> labelCount(n + 1, 0);
+    vector<vector<int>> strongRoots(n + 1);
+
+    for (int v = 0; v < n; v++) {
+        if (v == source || v == sink) {
+            continue;
+        }
+        if (excess[v] > 0) {
+            label[v] = 1;
+            strongRoots[1].push_back(v);
+        }
+        labelCount[label[v]]++;
+    }
+
+    convertSpan.end();
+
+    auto addRelationship = [&](int newParent, int child, int arc) {
+        parent[child] = newParent;
+        arcToParent[child] = arc;
+        prevSibling[child] = -1;
+        nextSibling[child] = firstChild[newParent];
+        if (firstChild[newParent] != -1) {
+            prevSibling[firstChild[newParent]] = child;
+        }
+        firstChild[newParent] = child;
+        };
+
+    auto breakRelationship = [&](int oldParent, int child) {
+        if (prevSibling[child] != -1) {
+            nextSibling[prevSibling[child]] = nextSibling[child];
+        }
+        else {
+            firstChild[oldParent] = nextSibling[child];
+        }
+        if (nextSibling[child] != -1) {
+            prevSibling[nextSibling[child]] = prevSibling[child];
+        }
+        parent[child] = -1;
+        arcToParent[child] = -1;
+        prevSibling[child] = -1;
+        nextSibling[child] = -1;
+        };
+
+    // Поиск дуги слияния: остаточная дуга в вершину с меткой на единицу меньше
+    auto findWeakNode = [&](int strongNode) -> int {
+        vector<PseudoflowArc>& arcs = residual[strongNode];
+        int target = label[strongNode] - 1;
+
+        for (int& i = currentArc[strongNode]; i < (int)arcs.size(); ++i) {
+            if (arcs[i].capacity > 0 && label[arcs[i].to] == target) {
+                return i;
+            }
+        }
+        return -1;
+        };
+
+    // Подвешиваем путь от strongNode до корня сильного дерева к слабой вершине
+    auto merge = [&](int weakNode, int strongNode, int arc) {
+        int current = strongNode;
+        int newParent = weakNode;
+        int newArc = arc;
+
+        while (parent[current] != -1) {
+            int oldParent = parent[current];
+            int oldArc = arcToParent[current];
+
+            breakRelationship(oldParent, current);
+            addRelationship(newParent, current, newArc);
+
+            newArc = residual[current][oldArc].rev;
+            newParent = current;
+            current = oldParent;
+        }
+
+        addRelationship(newParent, current, newArc);
+        };
+
+    // Проталкиваем избыток бывшего корня вверх до нового корня, разрезая насыщенные дуги
+    auto pushExcess = [&](int strongRoot) {
+        int current = strongRoot;
+        int prevExcess = 1;
+
+        while (excess[current] > 0 && parent[current] != -1) {
+            int up = parent[current];
+            prevExcess = excess[up];
+
+            PseudoflowArc& arc = residual[current][arcToParent[current]];
+            int flow = min(excess[current], arc.capacity);
+
+            arc.capacity -= flow;
+            residual[up][arc.rev].capacity += flow;
+            excess[up] += flow;
+            excess[current] -= flow;
+
+            if (excess[current] > 0) {
+                breakRelationship(up, current);
+                strongRoots[label[current]].push_back(current);
+            }
+
+            current = up;
+        }
+
+        if (excess[current] > 0 && prevExcess <= 0) {
+            strongRoots[label[current]].push_back(current);
+        }
+        };
+
+    // Поднимаем метку вершины, если среди оставшихся детей нет вершин с той же меткой
+    auto checkChildren = [&](int node) {
+        for (; nextScan[node] != -1; nextScan[node] = nextSibling[nextScan[node]]) {
+            if (label[nextScan[node]] == label[node]) {
+                return;
+            }
+        }
+
+        labelCount[label[node]]--;
+        label[node]++;
+        labelCount[label[node]]++;
+        currentArc[node] = 0;
+        };
+
+    // Дерево без пути вниз по меткам целиком уходит на сторону источника
+    auto liftAll = [&](int root) {
+        vector<int> stack = { root };
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+
+            labelCount[label[u]]--;
+            label[u] = n;
+
+            for (int child = firstChild[u]; child != -1; child = nextSibling[child]) {
+                stack.push_back(child);
+            }
+        }
+        };
+
+    // Слабое дерево, получившее избыток, становится сильным: его вершины с меткой 0 получают метку 1
+    auto raiseZeroLabels = [&](int root) {
+        vector<int> stack = { root };
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+
+            labelCount[0]--;
+            label[u] = 1;
+            labelCount[1]++;
+
+            for (int child = firstChild[u]; child != -1; child = nextSibling[child]) {
+                if (label[child] == 0) {
+                    stack.push_back(child);
+                }
+            }
+        }
+        };
+
+    auto processRoot = [&](int strongRoot) {
+        int strongNode = strongRoot;
+        nextScan[strongRoot] = firstChild[strongRoot];
+
+        int arc = findWeakNode(strongRoot);
+        if (arc != -1) {
+            merge(residual[strongRoot][arc].to, strongRoot, arc);
+            pushExcess(strongRoot);
+            return false;
+        }
+        checkChildren(strongRoot);
+
+        while (strongNode != -1) {
+            while (nextScan[strongNode] != -1) {
+                int child = nextScan[strongNode];
+                nextScan[strongNode] = nextSibling[child];
+                strongNode = child;
+                nextScan[strongNode] = firstChild[strongNode];
+
+                arc = findWeakNode(strongNode);
+                if (arc != -1) {
+                    merge(residual[strongNode][arc].to, strongNode, arc);
+                    pushExcess(strongRoot);
+                    return false;
+                }
+                checkChildren(strongNode);
+            }
+
+            strongNode = parent[strongNode];
+            if (strongNode != -1) {
+                checkChildren(strongNode);
+            }
+        }
+
+        strongRoots[label[strongRoot]].push_back(strongRoot);
+        return true;
+        };
+
+    // Первая фаза: обрабатываем сильные корни в порядке убывания меток
+    TraceSpan phaseSpan("pseudoflow", "first phase");
+    int highestStrongLabel = 1;
+    while (true) {
+        int strongRoot = -1;
+
+        for (int i = highestStrongLabel; i > 0 && strongRoot == -1; --i) {
+            if (strongRoots[i].empty()) {
+                continue;
+            }
+
+            highestStrongLabel = i;
+            if (labelCount[i - 1] > 0) {
+                strongRoot = strongRoots[i].back();
+                strongRoots[i].pop_back();
+                break;
+            }
+
+            while (!strongRoots[i].empty()) {
+                liftAll(strongRoots[i].back());
+                strongRoots[i].pop_back();
+            }
+        }
+
+        // Слабые деревья, ставшие сильными с меткой 0, переводим на метку 1
+        if (strongRoot == -1 && !strongRoots[0].empty()) {
+            while (!strongRoots[0].empty()) {
+                int root = strongRoots[0].back();
+                strongRoots[0].pop_back();
+                raiseZeroLabels(root);
+                strongRoots[1].push_back(root);
+            }
+            highestStrongLabel = 1;
+            continue;
+        }
+
+        if (strongRoot == -1) {
+            break;
+        }
+
+        if (processRoot(strongRoot)) {
+            highestStrongLabel++;
+        }
+    }
+
+    phaseSpan.end();
+
+    // Минимальный разрез: источник и все вершины, поднятые до метки n
+    TraceSpan cutSpan("pseudoflow", "cut");
+    label[source] = n;
+    for (int v = 0; v < n; v++) {
+        if (v != sink && label[v] == n) {
+            sourceSide.push_back(indexToNodeId[v]);
+        }
+    }
+
+    // Неориентированное ребро пересекает разрез в любом направлении
+    int cutValue = 0;
+    for (auto& pair : graph) {
+        bool uInSource = label[nodeIdToIndex[pair.first]] == n;
+        for (Edge* edge : pair.second->edges) {
+            bool vInSource = label[nodeIdToIndex[edge->adjacentNode->id]] == n;
+            if ((uInSource && !vInSource) || (edge->undirected && vInSource && !uInSource)) {
+                cutValue += edge->weight;
+            }
+        }
+    }
+
+    return cutValue;
+}
+
+int pseudoflow(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
+    vector<int> sourceSide;
+    return pseudoflowMinCut(graph, sourceId, sinkId, sourceSide);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+#include <vector>
+
+// Возвращает величину минимального разреза (= максимальному потоку) после первой фазы HPF
+int pseudoflow(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId);
+
+// То же самое, дополнительно заполняет sourceSide вершинами со стороны источника
+int pseudoflowMinCut(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId, std::vector<int>& sourceSide);
\ No newline at end of file
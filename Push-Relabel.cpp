@@ -1,4 +1,6 @@
 #include "Push-Relabel.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -11,7 +13,7 @@ using namespace std;
 // Вспомогательная функция для добавления ребра в остаточную сеть
 void addResidualEdge(unordered_map<int, unordered_map<int, int>>& residual,
     int from, int to, int capacity) {
-    residual[from][to] = capacity;
+    residual[from][to] += capacity;
 }
 
 int pushRelabel(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
@@ -32,6 +34,9 @@ int pushRelabel(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
         return 0;
     }
 
+    TraceSpan solveSpan("pushRelabel", "solve");
+    TraceSpan convertSpan("pushRelabel", "convert");
+
     int n = graph.size();
 
     // Создаем остаточную сеть
@@ -45,13 +50,20 @@ int pushRelabel(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
         for (Edge* edge : uNode->edges) {
             int v = edge->adjacentNode->id;
             addResidualEdge(residual, u, v, edge->weight);
-            // Инициализируем обратное ребро если еще не существует
-            if (residual[v].find(u) == residual[v].end()) {
-                addResidualEdge(residual, v, u, 0);
-            }
+            // Обратное ребро: у неориентированного ребра несет тот же вес, иначе создается пустым
+            addResidualEdge(residual, v, u, edge->undirected ? edge->weight : 0);
         }
     }
 
+    // Начальная остаточная сеть нужна только отладочному хуку для восстановления потока
+    CertificateHook hook = getCertificateHook();
+    unordered_map<int, unordered_map<int, int>> initialResidual;
+    if (hook) {
+        initialResidual = residual;
+    }
+
+    convertSpan.end();
+
     // Высоты вершин
     unordered_map<int, int> height;
 
@@ -83,6 +95,7 @@ int pushRelabel(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
     }
 
     // Основной цикл алгоритма
+    TraceSpan dischargeSpan("pushRelabel", "discharge");
     while (!activeVertices.empty()) {
         int u = activeVertices.front();
         activeVertices.pop();
@@ -136,6 +149,28 @@ int pushRelabel(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
             // Возвращаем вершину в очередь
             activeVertices.push(u);
         }
+        else if (excess[u] > 0) {
+            // Протолкнули не весь избыток - вершина остается активной
+            activeVertices.push(u);
+        }
+    }
+
+    dischargeSpan.end();
+
+    if (hook) {
+        TraceSpan span("pushRelabel", "certificate");
+        unordered_map<Node*, unordered_map<Node*, int>> netFlow;
+        for (auto& from : initialResidual) {
+            for (auto& to : from.second) {
+                netFlow[graph[from.first]][graph[to.first]] = to.second - residual[from.first][to.first];
+            }
+        }
+
+        FlowCertificate certificate;
+        certificate.flowValue = excess[sinkId];
+        assignNetFlow(graph, netFlow, certificate);
+        buildResidualCut(graph, sourceId, certificate);
+        hook("pushRelabel", graph, sourceId, sinkId, certificate);
     }
 
     // Максимальный поток равен избыточному потоку в стоке
@@ -0,0 +1,615 @@
+#include "RegionPushRelabel.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility>
+#include <memory>
+#include <climits>
+
+using namespace std;
+
+namespace {
+
+// Рабочие потоки на время одного решения. Потоки запускаются один раз, а список регионов
+// очередного цвета получают через условную переменную; вызывающий поток работает как поток 0.
+class RegionWorkerPool {
+public:
+    RegionWorkerPool(int threadCount, function<void(int, int)> discharge)
+        : discharge(discharge), work(nullptr), nextWork(0), generation(0), busyWorkers(0), stopping(false) {
+        for (int t = 1; t < threadCount; t++) {
+            threads.emplace_back(&RegionWorkerPool::workerLoop, this, t);
+        }
+    }
+
+    ~RegionWorkerPool() {
+        {
+            lock_guard<mutex> lock(poolMutex);
+            stopping = true;
+        }
+        workReady.notify_all();
+        for (thread& worker : threads) {
+            worker.join();
+        }
+    }
+
+    // Разряжает регионы из regions всеми потоками и возвращается, когда все они закончили
+    void run(const vector<int>& regions) {
+        {
+            lock_guard<mutex> lock(poolMutex);
+            work = &regions;
+            nextWork = 0;
+            generation++;
+            busyWorkers = threads.size();
+        }
+        workReady.notify_all();
+
+        drain(0);
+
+        unique_lock<mutex> lock(poolMutex);
+        workDone.wait(lock, [&]() { return busyWorkers == 0; });
+    }
+
+private:
+    void drain(int worker) {
+        size_t i;
+        while ((i = nextWork.fetch_add(1)) < work->size()) {
+            discharge(worker, (*work)[i]);
+        }
+    }
+
+    void workerLoop(int worker) {
+        unsigned seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(poolMutex);
+                workReady.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+
+            drain(worker);
+
+            lock_guard<mutex> lock(poolMutex);
+            if (--busyWorkers == 0) {
+                workDone.notify_one();
+            }
+        }
+    }
+
+    function<void(int, int)> discharge;
+    vector<thread> threads;
+    mutex poolMutex;
+    condition_variable workReady;
+    condition_variable workDone;
+    const vector<int>* work;
+    atomic<size_t> nextWork;
+    unsigned generation;
+    size_t busyWorkers;
+    bool stopping;
+};
+
+}
+
+int regionPushRelabel(unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    int numThreads, size_t regionBytes) {
+    // Проверка входных данных
+    if (graph.empty()) {
+        return 0;
+    }
+
+    if (graph.find(sourceId) == graph.end()) {
+        return 0;
+    }
+
+    if (graph.find(sinkId) == graph.end()) {
+        return 0;
+    }
+
+    if (sourceId == sinkId) {
+        return 0;
+    }
+
+    TraceSpan solveSpan("regionPushRelabel", "solve");
+    TraceSpan convertSpan("regionPushRelabel", "convert");
+
+    int n = graph.size();
+
+    // Сопоставляем ID вершинам индексы
+    unordered_map<int, int> nodeIdToIndex;
+    int index = 0;
+    for (auto& pair : graph) {
+        nodeIdToIndex[pair.first] = index++;
+    }
+
+    struct ArcInput {
+        int from;
+        int to;
+        int capacity;
+        int reverseCapacity;
+        Edge* edge;
+    };
+
+    vector<ArcInput> arcsInput;
+    for (auto& pair : graph) {
+        int u = nodeIdToIndex[pair.first];
+        for (Edge* edge : pair.second->edges) {
+            int v = nodeIdToIndex[edge->adjacentNode->id];
+            if (u != v) {
+                // Неориентированное ребро - одна пара дуг с весом в обе стороны
+                arcsInput.push_back({ u, v, edge->weight, edge->undirected ? edge->weight : 0, edge });
+            }
+        }
+    }
+
+    // Остаточная сеть в виде плоских массивов (CSR): дуги вершины u лежат в [firstArc[u], firstArc[u + 1])
+    vector<int> firstArc;
+    vector<int> arcTo;
+    vector<int> arcCap;
+    vector<int> arcRev;
+    vector<int> forwardArc;
+
+    auto buildResidual = [&]() {
+        firstArc.assign(n + 1, 0);
+        for (const ArcInput& a : arcsInput) {
+            firstArc[a.from + 1]++;
+            firstArc[a.to + 1]++;
+        }
+        for (int u = 0; u < n; u++) {
+            firstArc[u + 1] += firstArc[u];
+        }
+
+        int m = firstArc[n];
+        arcTo.assign(m, 0);
+        arcCap.assign(m, 0);
+        arcRev.assign(m, 0);
+
+        forwardArc.assign(arcsInput.size(), 0);
+
+        vector<int> pos(firstArc.begin(), firstArc.end() - 1);
+        for (size_t i = 0; i < arcsInput.size(); i++) {
+            const ArcInput& a = arcsInput[i];
+            int forward = pos[a.from]++;
+            int backward = pos[a.to]++;
+            forwardArc[i] = forward;
+
+            arcTo[forward] = a.to;
+            arcCap[forward] = a.capacity;
+            arcRev[forward] = backward;
+
+            arcTo[backward] = a.from;
+            arcCap[backward] = a.reverseCapacity;
+            arcRev[backward] = forward;
+        }
+        };
+
+    buildResidual();
+
+    // Перенумеровываем вершины в порядке обхода в ширину от источника,
+    // чтобы соседние вершины оказывались в одном регионе
+    vector<int> newIndex(n, -1);
+    int nextIndex = 0;
+    auto renumberFrom = [&](int start) {
+        queue<int> q;
+        q.push(start);
+        newIndex[start] = nextIndex++;
+
+        while (!q.empty()) {
+            int u = q.front();
+            q.pop();
+
+            for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+                int v = arcTo[a];
+                if (newIndex[v] == -1) {
+                    newIndex[v] = nextIndex++;
+                    q.push(v);
+                }
+            }
+        }
+        };
+
+    renumberFrom(nodeIdToIndex[sourceId]);
+    for (int u = 0; u < n; u++) {
+        if (newIndex[u] == -1) {
+            renumberFrom(u);
+        }
+    }
+
+    for (ArcInput& a : arcsInput) {
+        a.from = newIndex[a.from];
+        a.to = newIndex[a.to];
+    }
+    buildResidual();
+
+    int source = newIndex[nodeIdToIndex[sourceId]];
+    int sink = newIndex[nodeIdToIndex[sinkId]];
+
+    // Размер региона подбирается так, чтобы его вершины и дуги помещались в regionBytes
+    size_t averageDegree = (firstArc[n] + n - 1) / n;
+    size_t bytesPerVertex = 4 * sizeof(int) + averageDegree * 3 * sizeof(int);
+    int regionSize = max<size_t>(1, regionBytes / bytesPerVertex);
+    int numRegions = (n + regionSize - 1) / regionSize;
+
+    auto regionOf = [&](int u) {
+        return u / regionSize;
+        };
+
+    // Раскраска графа регионов: регионы одного цвета не имеют общих дуг
+    // и могут разряжаться одновременно
+    vector<vector<int>> regionNeighbors(numRegions);
+    for (int u = 0; u < n; u++) {
+        for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+            if (regionOf(arcTo[a]) != regionOf(u)) {
+                regionNeighbors[regionOf(u)].push_back(regionOf(arcTo[a]));
+            }
+        }
+    }
+
+    vector<int> regionColor(numRegions, -1);
+    int numColors = 0;
+    for (int r = 0; r < numRegions; r++) {
+        vector<int>& neighbors = regionNeighbors[r];
+        sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+        vector<char> used(numColors + 1, 0);
+        for (int other : neighbors) {
+            if (regionColor[other] != -1) {
+                used[regionColor[other]] = 1;
+            }
+        }
+
+        int color = 0;
+        while (used[color]) {
+            color++;
+        }
+        regionColor[r] = color;
+        numColors = max(numColors, color + 1);
+    }
+
+    convertSpan.end();
+
+    vector<int> height(n, 0);
+    vector<int> excess(n, 0);
+    vector<int> current(n, 0);
+    vector<char> isActive(n, 0);
+    vector<vector<int>> regionActive(numRegions);
+
+    auto activate = [&](int u) {
+        if (u != source && u != sink && excess[u] > 0 && height[u] < n && !isActive[u]) {
+            isActive[u] = 1;
+            regionActive[regionOf(u)].push_back(u);
+        }
+        };
+
+    // Глобальная перемаркировка: точные расстояния до стока в остаточной сети
+    auto globalRelabel = [&]() {
+        TraceSpan span("regionPushRelabel", "global relabel");
+        fill(height.begin(), height.end(), n);
+        height[sink] = 0;
+
+        queue<int> q;
+        q.push(sink);
+
+        while (!q.empty()) {
+            int v = q.front();
+            q.pop();
+
+            for (int a = firstArc[v]; a < firstArc[v + 1]; a++) {
+                int u = arcTo[a];
+                if (u != source && height[u] == n && arcCap[arcRev[a]] > 0) {
+                    height[u] = height[v] + 1;
+                    q.push(u);
+                }
+            }
+        }
+
+        for (int u = 0; u < n; u++) {
+            current[u] = firstArc[u];
+            isActive[u] = 0;
+        }
+        for (int r = 0; r < numRegions; r++) {
+            regionActive[r].clear();
+        }
+        for (int u = 0; u < n; u++) {
+            activate(u);
+        }
+        };
+
+    // Рабочие буферы одного потока: отложенный поток через границу и очереди локальной перемаркировки
+    struct RegionWorkspace {
+        vector<pair<int, int>> outflow;
+        vector<pair<int, int>> seeds;
+        vector<int> queue;
+    };
+
+    // Локальная перемаркировка региона: точные расстояния до стока при фиксированных высотах
+    // вершин за границей региона. Вершины без выхода сразу получают высоту n.
+    auto regionRelabel = [&](int r, RegionWorkspace& workspace) {
+        int begin = r * regionSize;
+        int end = min(n, begin + regionSize);
+
+        workspace.seeds.clear();
+        workspace.queue.clear();
+
+        for (int u = begin; u < end; u++) {
+            current[u] = firstArc[u];
+            if (u == source) {
+                continue;
+            }
+            if (u == sink) {
+                workspace.seeds.push_back({ 0, u });
+                continue;
+            }
+
+            int best = n;
+            for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+                if (arcCap[a] > 0 && regionOf(arcTo[a]) != r) {
+                    best = min(best, height[arcTo[a]] + 1);
+                }
+            }
+
+            height[u] = best;
+            if (best < n) {
+                workspace.seeds.push_back({ best, u });
+            }
+        }
+
+        sort(workspace.seeds.begin(), workspace.seeds.end());
+
+        // Обход в ширину, сливающий отсортированные стартовые вершины с очередью
+        size_t nextSeed = 0;
+        size_t head = 0;
+        while (nextSeed < workspace.seeds.size() || head < workspace.queue.size()) {
+            int v;
+            if (head == workspace.queue.size() ||
+                (nextSeed < workspace.seeds.size() &&
+                    workspace.seeds[nextSeed].first <= height[workspace.queue[head]])) {
+                v = workspace.seeds[nextSeed].second;
+                if (height[v] != workspace.seeds[nextSeed++].first) {
+                    continue;
+                }
+            }
+            else {
+                v = workspace.queue[head++];
+            }
+
+            for (int a = firstArc[v]; a < firstArc[v + 1]; a++) {
+                int u = arcTo[a];
+                if (regionOf(u) == r && u != source && u != sink &&
+                    arcCap[arcRev[a]] > 0 && height[u] > height[v] + 1) {
+                    height[u] = height[v] + 1;
+                    workspace.queue.push_back(u);
+                }
+            }
+        }
+        };
+
+    // Разрядка одного региона. Высоты вершин за его пределами фиксированы,
+    // поток через границу копится в outflow и применяется после синхронизации
+    auto dischargeRegion = [&](int r, RegionWorkspace& workspace) {
+        TraceSpan span("regionPushRelabel", "discharge region");
+        span.annotate("region", r);
+        vector<int>& active = regionActive[r];
+        int relabels = 0;
+
+        regionRelabel(r, workspace);
+
+        for (size_t head = 0; head < active.size(); head++) {
+            int u = active[head];
+            isActive[u] = 0;
+
+            while (excess[u] > 0 && height[u] < n) {
+                for (; current[u] < firstArc[u + 1]; current[u]++) {
+                    int a = current[u];
+                    int v = arcTo[a];
+
+                    if (arcCap[a] > 0 && height[u] == height[v] + 1) {
+                        int flow = min(excess[u], arcCap[a]);
+
+                        arcCap[a] -= flow;
+                        arcCap[arcRev[a]] += flow;
+                        excess[u] -= flow;
+
+                        if (regionOf(v) == r) {
+                            excess[v] += flow;
+                            activate(v);
+                        }
+                        else {
+                            workspace.outflow.push_back({ v, flow });
+                        }
+
+                        if (excess[u] == 0) {
+                            break;
+                        }
+                    }
+                }
+
+                if (excess[u] > 0) {
+                    // Подъем: минимальная высота среди соседей с остаточной пропускной способностью
+                    int minHeight = n;
+                    for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+                        if (arcCap[a] > 0) {
+                            minHeight = min(minHeight, height[arcTo[a]]);
+                        }
+                    }
+                    height[u] = min(n, minHeight + 1);
+                    current[u] = firstArc[u];
+
+                    if (++relabels > regionSize) {
+                        regionRelabel(r, workspace);
+                        relabels = 0;
+                    }
+                }
+            }
+        }
+
+        active.clear();
+        };
+
+    auto applyOutflow = [&](RegionWorkspace& workspace) {
+        for (auto& transfer : workspace.outflow) {
+            excess[transfer.first] += transfer.second;
+            activate(transfer.first);
+        }
+        workspace.outflow.clear();
+        };
+
+    // Инициализация предпотока: насыщаем все дуги из источника
+    for (int a = firstArc[source]; a < firstArc[source + 1]; a++) {
+        int flow = arcCap[a];
+        if (flow > 0) {
+            arcCap[a] = 0;
+            arcCap[arcRev[a]] += flow;
+            excess[arcTo[a]] += flow;
+            excess[source] -= flow;
+        }
+    }
+
+    globalRelabel();
+    height[source] = n;
+
+    int threadCount = max(1, numThreads);
+    vector<RegionWorkspace> workspaces(threadCount);
+
+    // Пул создается при первом проходе, где есть что разряжать параллельно
+    const size_t MIN_PARALLEL_VERTICES = 256;
+    unique_ptr<RegionWorkerPool> pool;
+
+    // Основной цикл: проходы по цветам регионов с глобальной перемаркировкой между проходами
+    while (true) {
+        bool hasActive = false;
+        for (int r = 0; r < numRegions && !hasActive; r++) {
+            hasActive = !regionActive[r].empty();
+        }
+        if (!hasActive) {
+            break;
+        }
+
+        for (int color = 0; color < numColors; color++) {
+            TraceSpan colorSpan("regionPushRelabel", "color pass");
+            colorSpan.annotate("color", color);
+            vector<int> work;
+            size_t workVertices = 0;
+            for (int r = 0; r < numRegions; r++) {
+                if (regionColor[r] == color && !regionActive[r].empty()) {
+                    work.push_back(r);
+                    workVertices += regionActive[r].size();
+                }
+            }
+
+            // На малом числе активных вершин передача работы потокам дороже самой разрядки
+            if (threadCount == 1 || work.size() < 2 || workVertices < MIN_PARALLEL_VERTICES) {
+                for (int r : work) {
+                    dischargeRegion(r, workspaces[0]);
+                }
+                applyOutflow(workspaces[0]);
+                continue;
+            }
+
+            if (!pool) {
+                pool.reset(new RegionWorkerPool(threadCount, [&](int worker, int r) {
+                    dischargeRegion(r, workspaces[worker]);
+                    }));
+            }
+            pool->run(work);
+            for (int t = 0; t < threadCount; t++) {
+                applyOutflow(workspaces[t]);
+            }
+        }
+
+        globalRelabel();
+    }
+
+    int maxFlow = excess[sink];
+
+    // Для отладочного хука нужен поток, а не предпоток: вторая фаза возвращает
+    // оставшийся избыток в источник обычным проталкиванием с высотами от n
+    if (CertificateHook hook = getCertificateHook()) {
+        TraceSpan cleanupSpan("regionPushRelabel", "cleanup");
+        fill(height.begin(), height.end(), 2 * n);
+        height[source] = n;
+
+        queue<int> q;
+        q.push(source);
+        while (!q.empty()) {
+            int v = q.front();
+            q.pop();
+
+            for (int a = firstArc[v]; a < firstArc[v + 1]; a++) {
+                int u = arcTo[a];
+                if (u != sink && height[u] == 2 * n && arcCap[arcRev[a]] > 0) {
+                    height[u] = height[v] + 1;
+                    q.push(u);
+                }
+            }
+        }
+
+        queue<int> returning;
+        for (int u = 0; u < n; u++) {
+            current[u] = firstArc[u];
+            if (u != source && u != sink && excess[u] > 0) {
+                returning.push(u);
+            }
+        }
+
+        while (!returning.empty()) {
+            int u = returning.front();
+            returning.pop();
+
+            while (excess[u] > 0) {
+                if (current[u] == firstArc[u + 1]) {
+                    int minHeight = INT_MAX;
+                    for (int a = firstArc[u]; a < firstArc[u + 1]; a++) {
+                        if (arcCap[a] > 0) {
+                            minHeight = min(minHeight, height[arcTo[a]]);
+                        }
+                    }
+                    height[u] = minHeight + 1;
+                    current[u] = firstArc[u];
+                }
+
+                int a = current[u];
+                int v = arcTo[a];
+                if (arcCap[a] > 0 && height[u] == height[v] + 1) {
+                    int flow = min(excess[u], arcCap[a]);
+
+                    arcCap[a] -= flow;
+                    arcCap[arcRev[a]] += flow;
+                    excess[u] -= flow;
+                    excess[v] += flow;
+
+                    if (v != source && v != sink && excess[v] == flow) {
+                        returning.push(v);
+                    }
+                }
+                else {
+                    current[u]++;
+                }
+            }
+        }
+
+        cleanupSpan.end();
+
+        TraceSpan certificateSpan("regionPushRelabel", "certificate");
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        for (size_t i = 0; i < arcsInput.size(); i++) {
+            certificate.edgeFlow[arcsInput[i].edge] = arcsInput[i].capacity - arcCap[forwardArc[i]];
+        }
+        buildResidualCut(graph, sourceId, certificate);
+        hook("regionPushRelabel", graph, sourceId, sinkId, certificate);
+    }
+
+    // Максимальный поток равен избыточному потоку в стоке
+    return maxFlow;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "graph.h"
+#include <unordered_map>
+#include <cstddef>
+
+// Проталкивание предпотока с разбиением вершин на регионы размером с кэш (Delong-Boykov).
+// regionBytes - целевой объем рабочих данных одного региона, numThreads - число потоков
+// для одновременной разрядки несмежных регионов.
+int regionPushRelabel(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId,
+    int numThreads = 1, std::size_t regionBytes = 256 * 1024);
\ No newline at end of file
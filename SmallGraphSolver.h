@@ -0,0 +1,271 @@
+#pragma once
+
+#include "graph.h"
+#include "Dinic.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
+#include <unordered_map>
+#include <cstdint>
+
+// Алгоритм Диница для маленьких графов с размерами, известными при компиляции.
+// Все состояние - массивы фиксированного размера внутри объекта (на стеке вызывающего),
+// множества вершин - битовые маски, куча не используется. Все методы constexpr,
+// поэтому поток можно посчитать и во время компиляции.
+// Ребра хранятся списками "вперед": дуги 2i и 2i + 1 - прямая и обратная для ребра i.
+template <int MaxVertices, int MaxEdges>
+class SmallMaxFlow {
+public:
+    static_assert(MaxVertices > 0 && MaxEdges >= 0, "размеры графа должны быть положительными");
+
+    constexpr SmallMaxFlow()
+        : numVertices(0), numEdges(0), head(), arcTo(), arcNext(), capacity(), initialCapacity(),
+        level(), current(), reached(), blocked(), queue(), pathArcs() {
+        for (int v = 0; v < MaxVertices; v++) {
+            head[v] = -1;
+        }
+    }
+
+    constexpr int vertexCount() const {
+        return numVertices;
+    }
+
+    constexpr int edgeCount() const {
+        return numEdges;
+    }
+
+    // Добавляет ребро from -> to (вершины 0..MaxVertices-1); возвращает его номер
+    // или -1, если вершины вне диапазона или места под ребра больше нет
+    constexpr int addEdge(int from, int to, int weight, bool undirected = false) {
+        if (from < 0 || from >= MaxVertices || to < 0 || to >= MaxVertices || numEdges >= MaxEdges) {
+            return -1;
+        }
+
+        int forward = 2 * numEdges;
+        int backward = forward + 1;
+
+        arcTo[forward] = to;
+        initialCapacity[forward] = weight;
+        arcNext[forward] = head[from];
+        head[from] = forward;
+
+        arcTo[backward] = from;
+        initialCapacity[backward] = undirected ? weight : 0;
+        arcNext[backward] = head[to];
+        head[to] = backward;
+
+        numVertices = from + 1 > numVertices ? from + 1 : numVertices;
+        numVertices = to + 1 > numVertices ? to + 1 : numVertices;
+        return numEdges++;
+    }
+
+    // Поток по ребру после maxFlow (для неориентированного ребра может быть отрицательным)
+    constexpr int flow(int edge) const {
+        return initialCapacity[2 * edge] - capacity[2 * edge];
+    }
+
+    // Вершина на стороне источника минимального разреза после maxFlow
+    constexpr bool onSourceSide(int v) const {
+        return contains(reached, v);
+    }
+
+    constexpr int maxFlow(int source, int sink) {
+        for (int a = 0; a < 2 * numEdges; a++) {
+            capacity[a] = initialCapacity[a];
+        }
+
+        if (source < 0 || source >= numVertices || sink < 0 || sink >= numVertices || source == sink) {
+            clear(reached);
+            return 0;
+        }
+
+        int total = 0;
+        while (buildLevels(source, sink)) {
+            total += blockingFlow(source, sink);
+        }
+
+        // Последний обход в ширину оставил в reached вершины, достижимые из источника
+        return total;
+    }
+
+private:
+    static constexpr int MaskWords = (MaxVertices + 63) / 64;
+
+    static constexpr bool contains(const uint64_t (&mask)[MaskWords], int v) {
+        return (mask[v >> 6] >> (v & 63)) & 1;
+    }
+
+    static constexpr void insert(uint64_t (&mask)[MaskWords], int v) {
+        mask[v >> 6] |= uint64_t(1) << (v & 63);
+    }
+
+    static constexpr void clear(uint64_t (&mask)[MaskWords]) {
+        for (int i = 0; i < MaskWords; i++) {
+            mask[i] = 0;
+        }
+    }
+
+    // BFS по остаточной сети; reached - множество посещенных вершин
+    constexpr bool buildLevels(int source, int sink) {
+        clear(reached);
+        clear(blocked);
+
+        int tail = 0;
+        queue[tail++] = source;
+        insert(reached, source);
+        level[source] = 0;
+
+        for (int headIndex = 0; headIndex < tail; headIndex++) {
+            int u = queue[headIndex];
+            current[u] = head[u];
+
+            for (int a = head[u]; a != -1; a = arcNext[a]) {
+                int v = arcTo[a];
+                if (capacity[a] > 0 && !contains(reached, v)) {
+                    insert(reached, v);
+                    level[v] = level[u] + 1;
+                    queue[tail++] = v;
+                }
+            }
+        }
+
+        return contains(reached, sink);
+    }
+
+    // Блокирующий поток итеративным обходом в глубину; тупиковые вершины попадают в blocked
+    constexpr int blockingFlow(int source, int sink) {
+        int total = 0;
+        int depth = 0;
+        int u = source;
+
+        while (true) {
+            if (u == sink) {
+                int pushed = capacity[pathArcs[0]];
+                for (int i = 1; i < depth; i++) {
+                    pushed = capacity[pathArcs[i]] < pushed ? capacity[pathArcs[i]] : pushed;
+                }
+
+                int firstSaturated = depth;
+                for (int i = 0; i < depth; i++) {
+                    capacity[pathArcs[i]] -= pushed;
+                    capacity[pathArcs[i] ^ 1] += pushed;
+                    if (capacity[pathArcs[i]] == 0 && firstSaturated == depth) {
+                        firstSaturated = i;
+                    }
+                }
+
+                total += pushed;
+                depth = firstSaturated;
+                u = depth == 0 ? source : arcTo[pathArcs[depth - 1]];
+                continue;
+            }
+
+            int& a = current[u];
+            while (a != -1 && !(capacity[a] > 0 && !contains(blocked, arcTo[a]) &&
+                contains(reached, arcTo[a]) && level[arcTo[a]] == level[u] + 1)) {
+                a = arcNext[a];
+            }
+
+            if (a != -1) {
+                pathArcs[depth++] = a;
+                u = arcTo[a];
+                continue;
+            }
+
+            if (u == source) {
+                return total;
+            }
+
+            insert(blocked, u);
+            depth--;
+            u = depth == 0 ? source : arcTo[pathArcs[depth - 1]];
+            current[u] = arcNext[current[u]];
+        }
+    }
+
+    int numVertices;
+    int numEdges;
+    int head[MaxVertices];
+    int arcTo[2 * MaxEdges + 1];
+    int arcNext[2 * MaxEdges + 1];
+    int capacity[2 * MaxEdges + 1];
+    int initialCapacity[2 * MaxEdges + 1];
+    int level[MaxVertices];
+    int current[MaxVertices];
+    uint64_t reached[MaskWords];
+    uint64_t blocked[MaskWords];
+    int queue[MaxVertices];
+    int pathArcs[MaxVertices];
+};
+
+// Та же сигнатура, что у остальных алгоритмов. ID вершин сопоставляются индексам линейным
+// поиском в стековом массиве; если граф не помещается в MaxVertices/MaxEdges, вызывается dinic.
+template <int MaxVertices, int MaxEdges>
+int smallGraphMaxFlow(std::unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
+    // Проверка входных данных
+    if (graph.empty()) {
+        return 0;
+    }
+
+    if (graph.find(sourceId) == graph.end()) {
+        return 0;
+    }
+
+    if (graph.find(sinkId) == graph.end()) {
+        return 0;
+    }
+
+    if (sourceId == sinkId) {
+        return 0;
+    }
+
+    if ((int)graph.size() > MaxVertices) {
+        return dinic(graph, sourceId, sinkId);
+    }
+
+    // Сам решатель constexpr и интервалов трассы не пишет - только адаптер
+    TraceSpan solveSpan("smallGraphMaxFlow", "solve");
+    TraceSpan convertSpan("smallGraphMaxFlow", "convert");
+
+    int ids[MaxVertices] = {};
+    int n = 0;
+    for (auto& pair : graph) {
+        ids[n++] = pair.first;
+    }
+
+    auto indexOf = [&](int id) {
+        int i = 0;
+        while (ids[i] != id) {
+            i++;
+        }
+        return i;
+        };
+
+    SmallMaxFlow<MaxVertices, MaxEdges> solver;
+    Edge* edges[MaxEdges > 0 ? MaxEdges : 1] = {};
+    for (auto& pair : graph) {
+        int u = indexOf(pair.first);
+        for (Edge* edge : pair.second->edges) {
+            int e = solver.addEdge(u, indexOf(edge->adjacentNode->id), edge->weight, edge->undirected);
+            if (e == -1) {
+                return dinic(graph, sourceId, sinkId);
+            }
+            edges[e] = edge;
+        }
+    }
+
+    convertSpan.end();
+
+    int maxFlow = solver.maxFlow(indexOf(sourceId), indexOf(sinkId));
+
+    if (CertificateHook hook = getCertificateHook()) {
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        for (int e = 0; e < solver.edgeCount(); e++) {
+            certificate.edgeFlow[edges[e]] = solver.flow(e);
+        }
+        buildResidualCut(graph, sourceId, certificate);
+        hook("smallGraphMaxFlow", graph, sourceId, sinkId, certificate);
+    }
+
+    return maxFlow;
+}
@@ -0,0 +1,283 @@
+#include "SolverService.h"
+#include "SolverTrace.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+
+using namespace std;
+
+SolverService::ResidentGraph::~ResidentGraph() {
+    // Решатель ссылается на вершины, поэтому уничтожается первым
+    solver.reset();
+    for (auto& pair : nodes) {
+        for (Edge* edge : pair.second->edges) {
+            delete edge;
+        }
+        delete pair.second;
+    }
+}
+
+SolverService::SolverService(int numWorkers)
+    : numWorkers(max(1, numWorkers)), out(nullptr), stopping(false) {
+}
+
+SolverService::~SolverService() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void SolverService::writeLine(const string& line) {
+    lock_guard<mutex> lock(outputMutex);
+    *out << line << endl;
+}
+
+bool SolverService::loadGraph(istream& in, const string& handle, int edgeCount, bool undirected,
+    string& unreadLine) {
+    TraceSpan span("SolverService", "load");
+    span.annotate("edges", edgeCount);
+    auto graph = make_shared<ResidentGraph>();
+
+    auto getNode = [&](int id) {
+        Node*& node = graph->nodes[id];
+        if (!node) {
+            node = new Node(id);
+        }
+        return node;
+        };
+
+    // Каждое ребро - отдельная строка ровно из трех чисел, пропускная способность неотрицательна.
+    // Строка, начинающаяся не с числа, - уже следующая команда; испорченное ребро дочитывается
+    // вместе с остальными, но граф не загружается
+    string malformedLine;
+    bool malformed = false;
+    for (int i = 0; i < edgeCount; i++) {
+        string line;
+        if (!getline(in, line)) {
+            writeLine("error " + handle + " expected " + to_string(edgeCount) + " edges, got " + to_string(i));
+            return true;
+        }
+
+        istringstream edgeLine(line);
+        int from;
+        if (!(edgeLine >> from)) {
+            writeLine("error " + handle + " expected " + to_string(edgeCount) + " edges, got " + to_string(i));
+            unreadLine = line;
+            return false;
+        }
+
+        int to, capacity;
+        string extra;
+        if (!(edgeLine >> to >> capacity) || edgeLine >> extra || capacity < 0) {
+            if (!malformed) {
+                malformed = true;
+                malformedLine = line;
+            }
+            continue;
+        }
+        if (malformed) {
+            continue;
+        }
+
+        Node* fromNode = getNode(from);
+        Node* toNode = getNode(to);
+        if (undirected) {
+            addUndirectedEdge(fromNode, toNode, capacity);
+        }
+        else {
+            fromNode->edges.push_back(new Edge(capacity, toNode));
+            toNode->parents[fromNode] = fromNode->edges.back();
+        }
+    }
+
+    if (malformed) {
+        writeLine("error " + handle + " malformed edge line: " + malformedLine);
+        return true;
+    }
+
+    // Привязка решателя - единственное место, где выделяются его рабочие массивы
+    graph->solver.reset(new MaxFlowSolver(graph->nodes));
+    int vertices = graph->nodes.size();
+
+    {
+        // Пакеты, уже выполняющиеся на старом графе с тем же именем, доработают на нем
+        lock_guard<mutex> lock(queueMutex);
+        graphs[handle] = graph;
+    }
+
+    writeLine("loaded " + handle + " " + to_string(vertices) + " " + to_string(edgeCount));
+    return true;
+}
+
+void SolverService::enqueue(const string& handle, const SolveRequest& request) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+
+        auto it = graphs.find(handle);
+        if (it == graphs.end()) {
+            writeLine("error " + request.id + " unknown graph " + handle);
+            return;
+        }
+
+        // Вершины графа после загрузки не меняются; без этой проверки решатель вернул бы 0,
+        // неотличимый от настоящего нулевого потока
+        shared_ptr<ResidentGraph>& graph = it->second;
+        for (int id : { request.sourceId, request.sinkId }) {
+            if (graph->nodes.find(id) == graph->nodes.end()) {
+                writeLine("error " + request.id + " unknown vertex " + to_string(id));
+                return;
+            }
+        }
+        if (request.sourceId == request.sinkId) {
+            writeLine("error " + request.id + " source equals sink");
+            return;
+        }
+
+        graph->pending.push_back(request);
+        if (!graph->queued && !graph->busy) {
+            graph->queued = true;
+            ready.push_back(graph);
+        }
+    }
+    queueChanged.notify_one();
+}
+
+void SolverService::workerLoop() {
+    while (true) {
+        shared_ptr<ResidentGraph> graph;
+        deque<SolveRequest> batch;
+
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueChanged.wait(lock, [&]() { return stopping || !ready.empty(); });
+
+            if (ready.empty()) {
+                return;
+            }
+
+            // Забираем все накопившиеся запросы к графу одним пакетом
+            graph = ready.front();
+            ready.pop_front();
+            graph->queued = false;
+            graph->busy = true;
+            batch.swap(graph->pending);
+        }
+
+        TraceSpan batchSpan("SolverService", "batch");
+        batchSpan.annotate("requests", (long long)batch.size());
+        for (const SolveRequest& request : batch) {
+            int flow = graph->solver->solve(request.sourceId, request.sinkId);
+            writeLine("result " + request.id + " " + to_string(flow));
+        }
+        batchSpan.end();
+
+        {
+            lock_guard<mutex> lock(queueMutex);
+            graph->busy = false;
+            if (!graph->pending.empty()) {
+                graph->queued = true;
+                ready.push_back(graph);
+                queueChanged.notify_one();
+            }
+        }
+    }
+}
+
+void SolverService::run(istream& in, ostream& output) {
+    out = &output;
+    for (int i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&SolverService::workerLoop, this);
+    }
+
+    string line;
+    bool hasUnreadLine = false;
+    while (hasUnreadLine || getline(in, line)) {
+        hasUnreadLine = false;
+        istringstream command(line);
+        string name;
+        if (!(command >> name)) {
+            continue;
+        }
+
+        if (name == "load") {
+            string handle;
+            int edgeCount;
+            string mode;
+            if (!(command >> handle >> edgeCount) || edgeCount < 0 ||
+                (command >> mode && mode != "undirected")) {
+                writeLine("error - usage: load <handle> <edgeCount> [undirected]");
+                continue;
+            }
+            hasUnreadLine = !loadGraph(in, handle, edgeCount, mode == "undirected", line);
+        }
+        else if (name == "solve") {
+            SolveRequest request;
+            string handle;
+            if (!(command >> request.id >> handle >> request.sourceId >> request.sinkId)) {
+                writeLine("error - usage: solve <requestId> <handle> <source> <sink>");
+                continue;
+            }
+            enqueue(handle, request);
+        }
+        else if (name == "unload") {
+            string handle;
+            command >> handle;
+
+            bool erased;
+            {
+                // Уже принятые запросы к графу выполнятся: пакет держит ссылку на граф
+                lock_guard<mutex> lock(queueMutex);
+                erased = graphs.erase(handle) > 0;
+            }
+            writeLine(erased ? "unloaded " + handle : "error " + handle + " unknown graph " + handle);
+        }
+        else if (name == "trace") {
+            string mode;
+            string path;
+            command >> mode;
+            if (mode == "on" || mode == "off") {
+                setSolverTraceEnabled(mode == "on");
+                writeLine("trace " + mode);
+            }
+            else if (mode == "write" && command >> path) {
+                if (writeSolverTrace(path, true)) {
+                    writeLine("traced " + path);
+                }
+                else {
+                    writeLine("error - cannot write trace to " + path);
+                }
+            }
+            else {
+                writeLine("error - usage: trace on|off | trace write <file>");
+            }
+        }
+        else if (name == "quit") {
+            break;
+        }
+        else {
+            writeLine("error - unknown command " + name);
+        }
+    }
+
+    // Завершение: рабочие потоки выходят, когда очередь пуста
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        graphs.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "graph.h"
+#include "MaxFlowSolver.h"
+#include <unordered_map>
+#include <string>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <iostream>
+
+// Долгоживущий сервис решения задач о максимальном потоке поверх текстового потока (stdin/stdout).
+// Графы загружаются один раз и хранятся по имени; запросы к одному графу собираются в пакет
+// и выполняются одним рабочим потоком на переиспользуемом MaxFlowSolver, разные графы - параллельно.
+//
+// Команды (по одной в строке):
+//   load <handle> <edgeCount> [undirected]   далее edgeCount строк "<from> <to> <capacity>", capacity >= 0;
+//                                            с undirected все ребра графа неориентированные
+//   solve <requestId> <handle> <source> <sink>   источник и сток - разные вершины графа
+//   unload <handle>
+//   trace on|off                             включает или выключает трассировку фаз (SolverTrace.h)
+//   trace write <file>                       записывает накопленную трассу и очищает буферы
+//   quit
+// Ответы: "loaded <handle> <vertices> <edges>", "result <requestId> <flow>",
+// "unloaded <handle>", "trace on|off", "traced <file>", "error <requestId|handle|-> <сообщение>".
+// Результаты приходят по мере готовности, не обязательно в порядке запросов.
+class SolverService {
+public:
+    explicit SolverService(int numWorkers);
+    ~SolverService();
+
+    // Читает команды до конца потока или quit, дожидается выполнения всех принятых запросов
+    void run(std::istream& in, std::ostream& out);
+
+private:
+    struct SolveRequest {
+        std::string id;
+        int sourceId;
+        int sinkId;
+    };
+
+    struct ResidentGraph {
+        std::unordered_map<int, Node*> nodes;
+        std::unique_ptr<MaxFlowSolver> solver;
+        std::deque<SolveRequest> pending;
+        bool queued = false;
+        bool busy = false;
+
+        ~ResidentGraph();
+    };
+
+    // Читает edgeCount строк с ребрами. Строка, начинающаяся не с числа, не теряется: загрузка
+    // прерывается с ошибкой, строка возвращается в unreadLine и выполняется как команда.
+    // Возвращает false, если такая строка есть.
+    bool loadGraph(std::istream& in, const std::string& handle, int edgeCount, bool undirected,
+        std::string& unreadLine);
+    void enqueue(const std::string& handle, const SolveRequest& request);
+    void workerLoop();
+    void writeLine(const std::string& line);
+
+    int numWorkers;
+    std::ostream* out;
+    std::vector<std::thread> workers;
+
+    std::unordered_map<std::string, std::shared_ptr<ResidentGraph>> graphs;
+    std::deque<std::shared_ptr<ResidentGraph>> ready;
+    bool stopping;
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::mutex outputMutex;
+};
\ No newline at end of file
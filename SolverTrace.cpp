@@ -0,0 +1,160 @@
+#include "SolverTrace.h"
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+atomic<bool> solverTraceFlag(false);
+
+namespace {
+
+    struct TraceEvent {
+        const char* category;
+        const char* name;
+        const char* argName;
+        long long argValue;
+        long long start;
+        long long end;
+    };
+
+    // Буфер одного потока. Мьютекс почти всегда свободен: его берет только владелец
+    // при записи и writeSolverTrace/clearSolverTrace.
+    struct ThreadTraceBuffer {
+        int threadId;
+        mutex bufferMutex;
+        vector<TraceEvent> events;
+    };
+
+    // Все буферы живут до конца программы, чтобы интервалы завершившихся потоков попали в трассу
+    mutex registryMutex;
+    vector<unique_ptr<ThreadTraceBuffer>> buffers;
+    vector<ThreadTraceBuffer*> freeBuffers;
+    const long long traceOrigin = solverTraceNow();
+
+    // Владение буфером на время жизни потока; при выходе потока буфер возвращается в свободные
+    struct BufferLease {
+        ThreadTraceBuffer* buffer = nullptr;
+
+        ~BufferLease() {
+            if (buffer) {
+                lock_guard<mutex> lock(registryMutex);
+                freeBuffers.push_back(buffer);
+            }
+        }
+    };
+
+    thread_local BufferLease lease;
+
+    ThreadTraceBuffer* localBuffer() {
+        if (!lease.buffer) {
+            lock_guard<mutex> lock(registryMutex);
+            if (!freeBuffers.empty()) {
+                lease.buffer = freeBuffers.back();
+                freeBuffers.pop_back();
+            }
+            else {
+                buffers.emplace_back(new ThreadTraceBuffer());
+                buffers.back()->threadId = (int)buffers.size();
+                lease.buffer = buffers.back().get();
+            }
+        }
+        return lease.buffer;
+    }
+
+    void writeJsonString(ostream& out, const char* text) {
+        out << '"';
+        for (const char* c = text; *c; c++) {
+            if (*c == '"' || *c == '\\') {
+                out << '\\';
+            }
+            out << *c;
+        }
+        out << '"';
+    }
+
+    // Микросекунды от начала трассы с точностью до наносекунд
+    void writeMicroseconds(ostream& out, long long nanoseconds) {
+        if (nanoseconds < 0) {
+            out << '-';
+            nanoseconds = -nanoseconds;
+        }
+        string fraction = to_string(nanoseconds % 1000);
+        out << nanoseconds / 1000 << '.' << string(3 - fraction.size(), '0') << fraction;
+    }
+}
+
+void setSolverTraceEnabled(bool enabled) {
+    solverTraceFlag.store(enabled, memory_order_relaxed);
+}
+
+void recordSolverTraceSpan(const char* category, const char* name, long long start, long long end,
+    const char* argName, long long argValue) {
+    ThreadTraceBuffer* buffer = localBuffer();
+    lock_guard<mutex> lock(buffer->bufferMutex);
+    buffer->events.push_back({ category, name, argName, argValue, start, end });
+}
+
+void clearSolverTrace() {
+    lock_guard<mutex> lock(registryMutex);
+    for (auto& buffer : buffers) {
+        lock_guard<mutex> bufferLock(buffer->bufferMutex);
+        buffer->events.clear();
+    }
+}
+
+void writeSolverTrace(ostream& out, bool clear) {
+    lock_guard<mutex> lock(registryMutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"ph\":\"M\",\"pid\":1,\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"maxflow\"}}";
+
+    for (auto& buffer : buffers) {
+        // Потоки продолжают писать, пока идет вывод: под мьютексом буфера только снимаем копию
+        vector<TraceEvent> events;
+        {
+            lock_guard<mutex> bufferLock(buffer->bufferMutex);
+            if (clear) {
+                events.swap(buffer->events);
+            }
+            else {
+                events = buffer->events;
+            }
+        }
+
+        out << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":\"thread " << buffer->threadId << "\"}}";
+
+        for (const TraceEvent& event : events) {
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"cat\":";
+            writeJsonString(out, event.category);
+            out << ",\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"ts\":";
+            writeMicroseconds(out, event.start - traceOrigin);
+            out << ",\"dur\":";
+            writeMicroseconds(out, event.end - event.start);
+            if (event.argName) {
+                out << ",\"args\":{";
+                writeJsonString(out, event.argName);
+                out << ':' << event.argValue << '}';
+            }
+            out << '}';
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+bool writeSolverTrace(const string& path, bool clear) {
+    ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    writeSolverTrace(out, clear);
+    return (bool)out;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+// Трассировка фаз алгоритмов в формате Chrome Trace Event (chrome://tracing, ui.perfetto.dev).
+// Каждый поток пишет завершенные интервалы в собственный буфер; буфер завершившегося потока
+// достается следующему новому потоку, поэтому строки трассы соответствуют "слотам" потоков.
+// Пока трассировка выключена, интервал стоит одной проверки флага без обращения к часам.
+extern std::atomic<bool> solverTraceFlag;
+
+inline bool solverTraceEnabled() {
+    return solverTraceFlag.load(std::memory_order_relaxed);
+}
+
+void setSolverTraceEnabled(bool enabled);
+
+// Монотонное время в наносекундах (в трассе отсчитывается от загрузки программы)
+inline long long solverTraceNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Добавляет завершенный интервал в буфер текущего потока.
+// category, name и argName должны жить до записи трассы (строковые литералы).
+void recordSolverTraceSpan(const char* category, const char* name, long long start, long long end,
+    const char* argName, long long argValue);
+
+// Интервал трассы на время жизни объекта: category - имя алгоритма, name - фаза.
+// end() закрывает интервал раньше конца области видимости.
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name)
+        : category(category), name(name), argName(nullptr), argValue(0),
+        start(solverTraceEnabled() ? solverTraceNow() : -1) {
+    }
+
+    ~TraceSpan() {
+        end();
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Числовой аргумент интервала (номер фазы, протолкнутый поток), виден в деталях события
+    void annotate(const char* key, long long value) {
+        argName = key;
+        argValue = value;
+    }
+
+    void end() {
+        if (start >= 0) {
+            recordSolverTraceSpan(category, name, start, solverTraceNow(), argName, argValue);
+            start = -1;
+        }
+    }
+
+private:
+    const char* category;
+    const char* name;
+    const char* argName;
+    long long argValue;
+    long long start;
+};
+
+// Удаляет накопленные интервалы всех потоков
+void clearSolverTrace();
+
+// Записывает накопленные интервалы в JSON формата Chrome Trace Event; с clear записанные
+// интервалы удаляются, а записанные во время выгрузки попадут в следующую
+void writeSolverTrace(std::ostream& out, bool clear = false);
+bool writeSolverTrace(const std::string& path, bool clear = false);
@@ -1,4 +1,6 @@
 #include "graph.h"
+#include "FlowCertificate.h"
+#include "SolverTrace.h"
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -30,6 +32,8 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
         return 0;
     }
 
+    TraceSpan solveSpan("edmondsKarp", "solve");
+
     Node* source = graph[sourceId];
     Node* sink = graph[sinkId];
 
@@ -55,6 +59,7 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
     };
 
     // Build flow network
+    TraceSpan convertSpan("edmondsKarp", "convert");
     unordered_map<Node*, vector<FlowEdge*>> flowNetwork;
 
     // Initialize for all vertices
@@ -62,6 +67,10 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
         flowNetwork[pair.second] = vector<FlowEdge*>();
     }
 
+    // Forward arc of every original edge, kept only for the debug certificate hook
+    CertificateHook hook = getCertificateHook();
+    vector<pair<Edge*, FlowEdge*>> edgeArcs;
+
     // Convert your structure to flow network
     for (auto& pair : graph) {
         Node* fromNode = pair.second;
@@ -72,22 +81,30 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
 
             // Forward edge
             FlowEdge* forward = new FlowEdge(toNode, capacity);
-            FlowEdge* backward = new FlowEdge(fromNode, 0);
+            // Undirected edge: the same arc pair, the reverse arc carries the capacity too
+            FlowEdge* backward = new FlowEdge(fromNode, edge->undirected ? capacity : 0);
 
             forward->reverse = backward;
             backward->reverse = forward;
 
             flowNetwork[fromNode].push_back(forward);
             flowNetwork[toNode].push_back(backward);
+
+            if (hook) {
+                edgeArcs.push_back({ edge, forward });
+            }
         }
     }
 
+    convertSpan.end();
+
     // Edmonds-Karp algorithm
     int maxFlow = 0;
     int iterations = 0;
 
     while (true) {
         // BFS to find augmenting path
+        TraceSpan bfsSpan("edmondsKarp", "bfs");
         unordered_map<Node*, Node*> parent;
         unordered_map<Node*, FlowEdge*> path;
 
@@ -118,11 +135,14 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
             }
         }
 
+        bfsSpan.end();
+
         if (!foundPath) {
             break; // No more augmenting paths
         }
 
         iterations++;
+        TraceSpan augmentSpan("edmondsKarp", "augment");
 
         // Find bottleneck
         int bottleneck = INT_MAX;
@@ -138,6 +158,7 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
         }
 
         maxFlow += bottleneck;
+        augmentSpan.annotate("pushed", bottleneck);
 
         // Safety to prevent infinite loops
         if (iterations > graph.size() * graph.size()) {
@@ -145,7 +166,19 @@ int edmondsKarp(unordered_map<int, Node*>& graph, int sourceId, int sinkId, bool
         }
     }
 
+    if (hook) {
+        TraceSpan span("edmondsKarp", "certificate");
+        FlowCertificate certificate;
+        certificate.flowValue = maxFlow;
+        for (auto& arc : edgeArcs) {
+            certificate.edgeFlow[arc.first] = arc.second->flow;
+        }
+        buildResidualCut(graph, sourceId, certificate);
+        hook("edmondsKarp", graph, sourceId, sinkId, certificate);
+    }
+
     // Cleanup
+    TraceSpan cleanupSpan("edmondsKarp", "cleanup");
     for (auto& pair : flowNetwork) {
         for (FlowEdge* edge : pair.second) {
             delete edge;
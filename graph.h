@@ -18,6 +18,19 @@ struct Edge
 {
     int weight;
     Node* adjacentNode;
+    // Неориентированное ребро: одна пара дуг с пропускной способностью weight в обе стороны.
+    // Хранится только в списке edges одного конца, поток по нему может быть отрицательным
+    bool undirected;
 
-    Edge(int w, Node* node) : weight(w), adjacentNode(node) {}
-};
\ No newline at end of file
+    Edge(int w, Node* node, bool isUndirected = false) : weight(w), adjacentNode(node), undirected(isUndirected) {}
+};
+
+// Добавляет неориентированное ребро между a и b; каждая вершина становится родителем другой
+inline Edge* addUndirectedEdge(Node* a, Node* b, int weight)
+{
+    Edge* edge = new Edge(weight, b, true);
+    a->edges.push_back(edge);
+    b->parents[a] = edge;
+    a->parents[b] = edge;
+    return edge;
+}
\ No newline at end of file
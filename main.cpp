@@ -3,6 +3,17 @@
 #include "edmonds_karp.h"
 #include "FordFulkerson.h"
 #include "Push-Relabel.h"
+#include "Pseudoflow.h"
+#include "RegionPushRelabel.h"
+#include "FlowCertificate.h"
+#include "MaxFlowSolver.h"
+#include "ParametricMaxFlow.h"
+#include "SolverService.h"
+#include "CompressedGraph.h"
+#include "LinkCutDinic.h"
+#include "GridGraph.h"
+#include "SmallGraphSolver.h"
+#include "SolverTrace.h"
 #include <iostream>
 #include <unordered_map>
 #include <vector>
@@ -10,6 +21,9 @@
 #include <chrono>
 #include <iomanip>
 #include <clocale>
+#include <string>
+#include <cstdlib>
+#include <thread>
 
 using namespace std;
 
@@ -224,6 +238,40 @@ void createZeroCapacityGraph(unordered_map<int, Node*>& graph) {
     graph[4]->parents[graph[3]] = graph[3]->edges.back();
 }
 
+// 7. НЕОРИЕНТИРОВАННЫЙ ГРАФ (каждое ребро - одна пара дуг с весом в обе стороны)
+void createUndirectedGraph(unordered_map<int, Node*>& graph) {
+    for (int i = 1; i <= 6; i++) {
+        graph[i] = new Node(i);
+    }
+
+    addUndirectedEdge(graph[1], graph[2], 7);
+    addUndirectedEdge(graph[1], graph[3], 4);
+    // Поток по этому ребру идет от 2 к 3, то есть против направления хранения
+    addUndirectedEdge(graph[3], graph[2], 3);
+    addUndirectedEdge(graph[2], graph[4], 5);
+    addUndirectedEdge(graph[3], graph[5], 6);
+    addUndirectedEdge(graph[4], graph[5], 2);
+    addUndirectedEdge(graph[4], graph[6], 4);
+    addUndirectedEdge(graph[5], graph[6], 8);
+}
+
+// Классический граф из createSmallGraph (вершины сдвинуты к 0..5), посчитанный при компиляции
+constexpr int compileTimeSmallGraphFlow() {
+    SmallMaxFlow<6, 9> solver;
+    solver.addEdge(0, 1, 16);
+    solver.addEdge(0, 2, 13);
+    solver.addEdge(1, 2, 12);
+    solver.addEdge(1, 3, 10);
+    solver.addEdge(2, 1, 9);
+    solver.addEdge(2, 4, 14);
+    solver.addEdge(3, 4, 7);
+    solver.addEdge(3, 5, 4);
+    solver.addEdge(4, 5, 20);
+    return solver.maxFlow(0, 5);
+}
+
+static_assert(compileTimeSmallGraphFlow() == 24, "SmallMaxFlow должен считаться во время компиляции");
+
 // Функция для подсчета характеристик графа
 void printGraphInfo(unordered_map<int, Node*>& graph, const string& name) {
     int vertices = graph.size();
@@ -254,11 +302,40 @@ void runSingleTest(unordered_map<int, Node*>& graph,
         << " (время: " << duration.count() << " мкс)" << endl;
 }
 
+// Повторный запуск переиспользуемого решателя: первый solve прогревает рабочие массивы,
+// замеряется второй, который уже не выделяет память
+void runReusableSolverTest(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
+    MaxFlowSolver solver(graph);
+    solver.solve(sourceId, sinkId);
+
+    auto start = chrono::high_resolution_clock::now();
+    int result = solver.solve(sourceId, sinkId);
+    auto end = chrono::high_resolution_clock::now();
+
+    auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
+
+    cout << "  MaxFlowSolver (повторный solve): " << result
+        << " (время: " << duration.count() << " мкс)" << endl;
+}
+
 // Обертка для edmondsKarp без verbose параметра
 int edmondsKarpSimple(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
     return edmondsKarp(graph, sourceId, sinkId, false);
 }
 
+// Обертка для regionPushRelabel: крошечные регионы и два потока,
+// чтобы на маленьких тестовых графах работал обмен потоком через границы регионов
+int regionPushRelabelSimple(unordered_map<int, Node*>& graph, int sourceId, int sinkId) {
+    return regionPushRelabel(graph, sourceId, sinkId, 2, 64);
+}
+
+// Запись трассы фаз, если она была включена ключом --trace
+void writeRequestedTrace(const string& tracePath) {
+    if (!tracePath.empty() && !writeSolverTrace(tracePath)) {
+        cerr << "Не удалось записать трассу в " << tracePath << endl;
+    }
+}
+
 // Основная функция тестирования
 void runTestSuite(const string& testName,
     void (*createGraphFunc)(unordered_map<int, Node*>&),
@@ -280,24 +357,63 @@ void runTestSuite(const string& testName,
 
     cout << "\nРезультаты алгоритмов:" << endl;
 
-    // Тестируем все четыре алгоритма
+    // Тестируем все алгоритмы
     runSingleTest(graph, "Форд-Фалкерсон", fordFulkerson, sourceId, sinkId);
     runSingleTest(graph, "Эдмондс-Карп", edmondsKarpSimple, sourceId, sinkId);
     runSingleTest(graph, "Диниц", dinic, sourceId, sinkId);
     runSingleTest(graph, "Проталкивание предпотока", pushRelabel, sourceId, sinkId);
+    runSingleTest(graph, "Псевдопоток (HPF)", pseudoflow, sourceId, sinkId);
+    runSingleTest(graph, "Проталкивание по регионам", regionPushRelabelSimple, sourceId, sinkId);
+    runSingleTest(graph, "Сжатый граф (Диниц)", compressedMaxFlow, sourceId, sinkId);
+    runSingleTest(graph, "Диниц (link-cut деревья)", linkCutDinic, sourceId, sinkId);
+    runSingleTest(graph, "Малый граф (стек, битовые маски)", smallGraphMaxFlow<64, 256>, sourceId, sinkId);
+    runReusableSolverTest(graph, sourceId, sinkId);
 
     cleanupGraph(graph);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     setlocale(LC_ALL, "");
+
+#ifdef _DEBUG
+    // В отладочной сборке каждый результат проверяется сертификатом за O(V + E)
+    setCertificateHook(reportFlowCertificate);
+#endif
+
+    // Трассировка фаз: "--trace <файл> [остальные ключи]"; при выходе в файл пишется трасса
+    // для chrome://tracing или ui.perfetto.dev
+    string tracePath;
+    if (argc > 2 && string(argv[1]) == "--trace") {
+        tracePath = argv[2];
+        setSolverTraceEnabled(true);
+        argc -= 2;
+        argv += 2;
+    }
+
+    // Режим сервиса: "--serve [число потоков]", команды читаются из stdin, ответы пишутся в stdout
+    if (argc > 1 && string(argv[1]) == "--serve") {
+        int numWorkers = argc > 2 ? atoi(argv[2]) : (int)thread::hardware_concurrency();
+        {
+            SolverService service(numWorkers);
+            service.run(cin, cout);
+        }
+        writeRequestedTrace(tracePath);
+        return 0;
+    }
+
     cout << "ТЕСТИРОВАНИЕ АЛГОРИТМОВ ПОИСКА МАКСИМАЛЬНОГО ПОТОКА" << endl;
     cout << "=====================================================" << endl;
-    cout << "Тестируются 4 алгоритма:" << endl;
+    cout << "Тестируются 10 алгоритмов:" << endl;
     cout << "1. Форд-Фалкерсон" << endl;
     cout << "2. Эдмондс-Карп" << endl;
     cout << "3. Диниц" << endl;
     cout << "4. Проталкивание предпотока (Push-Relabel)" << endl;
+    cout << "5. Псевдопоток Хохбаум (HPF)" << endl;
+    cout << "6. Проталкивание предпотока по регионам (Delong-Boykov)" << endl;
+    cout << "7. Диниц на сжатом графе (varint-списки смежности)" << endl;
+    cout << "8. Диниц с динамическими деревьями (Sleator-Tarjan)" << endl;
+    cout << "9. Диниц для малых графов на стековых массивах (шаблон, constexpr)" << endl;
+    cout << "10. Переиспользуемый MaxFlowSolver (Диниц, повторный solve без выделений памяти)" << endl;
 
     // Тест 1: Пустой граф
     runTestSuite("ПУСТОЙ ГРАФ (без ребер)", createEmptyGraph, 1, 3, 0);
@@ -331,6 +447,11 @@ int main() {
         cout << "  Эдмондс-Карп: " << edmondsKarp(graph, 1, 1, false) << endl;
         cout << "  Диниц: " << dinic(graph, 1, 1) << endl;
         cout << "  Проталкивание предпотока: " << pushRelabel(graph, 1, 1) << endl;
+        cout << "  Псевдопоток (HPF): " << pseudoflow(graph, 1, 1) << endl;
+        cout << "  Проталкивание по регионам: " << regionPushRelabel(graph, 1, 1) << endl;
+        cout << "  Сжатый граф (Диниц): " << compressedMaxFlow(graph, 1, 1) << endl;
+        cout << "  Диниц (link-cut деревья): " << linkCutDinic(graph, 1, 1) << endl;
+        cout << "  Малый граф (стек): " << smallGraphMaxFlow<64, 256>(graph, 1, 1) << endl;
         cleanupGraph(graph);
     }
 
@@ -343,6 +464,113 @@ int main() {
         cout << "  Эдмондс-Карп: " << edmondsKarp(graph, 1, 100, false) << endl;
         cout << "  Диниц: " << dinic(graph, 1, 100) << endl;
         cout << "  Проталкивание предпотока: " << pushRelabel(graph, 1, 100) << endl;
+        cout << "  Псевдопоток (HPF): " << pseudoflow(graph, 1, 100) << endl;
+        cout << "  Проталкивание по регионам: " << regionPushRelabel(graph, 1, 100) << endl;
+        cout << "  Сжатый граф (Диниц): " << compressedMaxFlow(graph, 1, 100) << endl;
+        cout << "  Диниц (link-cut деревья): " << linkCutDinic(graph, 1, 100) << endl;
+        cout << "  Малый граф (стек): " << smallGraphMaxFlow<64, 256>(graph, 1, 100) << endl;
+        cleanupGraph(graph);
+    }
+
+    // Тест 8: Параметрический поток на классическом графе:
+    // ребра из источника растут с наклоном 1, ребра в сток убывают с наклоном -1
+    {
+        cout << "\n" << string(60, '=') << endl;
+        cout << "ПАРАМЕТРИЧЕСКИЙ ПОТОК (lambda от -6 до 2)" << endl;
+        cout << string(60, '=') << endl;
+
+        unordered_map<int, Node*> graph;
+        createSmallGraph(graph);
+
+        unordered_map<Edge*, int> slope;
+        for (auto& pair : graph) {
+            for (Edge* edge : pair.second->edges) {
+                if (pair.first == 1) {
+                    slope[edge] = 1;
+                }
+                else if (edge->adjacentNode->id == 6) {
+                    slope[edge] = -1;
+                }
+            }
+        }
+
+        vector<double> lambdas = { -6, -4, -2, 0, 2 };
+        vector<double> flows = parametricMaxFlow(graph, 1, 6, slope, lambdas);
+        for (size_t i = 0; i < lambdas.size(); i++) {
+            cout << "  lambda = " << lambdas[i] << ": " << flows[i] << endl;
+        }
+
+        for (const ParametricBreakpoint& breakpoint : parametricBreakpoints(graph, 1, 6, slope, -6, 2)) {
+            cout << "  Точка излома: lambda = " << breakpoint.lambda
+                << ", разрез = " << breakpoint.cutValue << endl;
+        }
+        cleanupGraph(graph);
+    }
+
+    // Тест 9: Неориентированный граф
+    runTestSuite("НЕОРИЕНТИРОВАННЫЙ ГРАФ (6 вершин)", createUndirectedGraph, 1, 6, 11);
+
+    // Тест 10: Неявная решетка 8x8 (4-связность): левый столбец тянет к источнику, правый к стоку,
+    // по вертикальной линии x = 4 ребра слабые. Сверяем с Диницем на явном графе той же решетки
+    {
+        cout << "\n" << string(60, '=') << endl;
+        cout << "НЕЯВНАЯ РЕШЕТКА 8x8 (4-связность)" << endl;
+        cout << string(60, '=') << endl;
+
+        GridGraph grid(8, 8, 1, Grid4);
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x++) {
+                int pixel = grid.pixelIndex(x, y);
+                for (int k = 0; k < grid.directionCount(); k++) {
+                    int other = grid.neighbor(pixel, k);
+                    if (other != -1) {
+                        bool crossesSeam = (x == 3 && other == pixel + 1) || (x == 4 && other == pixel - 1);
+                        grid.setCapacity(pixel, k, crossesSeam ? 1 : 10);
+                    }
+                }
+                grid.setTerminalCapacities(pixel, x == 0 ? 20 : 0, x == 7 ? 20 : 0);
+            }
+        }
+
+        vector<char> sourceSide;
+        long long gridFlow = gridMaxFlow(grid, &sourceSide);
+
+        // Тот же граф в явном виде: пиксели 0..63, источник 64, сток 65
+        unordered_map<int, Node*> graph;
+        int pixels = grid.pixelCount();
+        for (int i = 0; i < pixels + 2; i++) {
+            graph[i] = new Node(i);
+        }
+        for (int pixel = 0; pixel < pixels; pixel++) {
+            for (int k = 0; k < grid.directionCount(); k++) {
+                int other = grid.neighbor(pixel, k);
+                if (other != -1) {
+                    graph[pixel]->edges.push_back(new Edge(grid.capacity(pixel, k), graph[other]));
+                    graph[other]->parents[graph[pixel]] = graph[pixel]->edges.back();
+                }
+            }
+            if (grid.sourceCapacity(pixel) > 0) {
+                graph[pixels]->edges.push_back(new Edge(grid.sourceCapacity(pixel), graph[pixel]));
+                graph[pixel]->parents[graph[pixels]] = graph[pixels]->edges.back();
+            }
+            if (grid.sinkCapacity(pixel) > 0) {
+                graph[pixel]->edges.push_back(new Edge(grid.sinkCapacity(pixel), graph[pixels + 1]));
+                graph[pixels + 1]->parents[graph[pixel]] = graph[pixel]->edges.back();
+            }
+        }
+
+        cout << "  Решетка (Бойков-Колмогоров): " << gridFlow << endl;
+        cout << "  Диниц на явном графе: " << dinic(graph, pixels, pixels + 1) << endl;
+        cout << "  Ожидаемый результат: 8" << endl;
+
+        cout << "  Разрез (S - сторона источника):" << endl;
+        for (int y = 0; y < 8; y++) {
+            cout << "    ";
+            for (int x = 0; x < 8; x++) {
+                cout << (sourceSide[grid.pixelIndex(x, y)] ? 'S' : '.');
+            }
+            cout << endl;
+        }
         cleanupGraph(graph);
     }
 
@@ -350,5 +578,6 @@ int main() {
     cout << "ТЕСТИРОВАНИЕ ЗАВЕРШЕНО" << endl;
     cout << string(60, '=') << endl;
 
+    writeRequestedTrace(tracePath);
     return 0;
 }
\ No newline at end of file